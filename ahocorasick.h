@@ -0,0 +1,272 @@
+#pragma once
+#include <cassert>
+#include <vector>
+#include "string.h"
+
+class AhoCorasick {
+public:
+    struct Match {
+        size_t pattern;
+        size_t position;
+    };
+
+private:
+    static constexpr unsigned NONE = ~0u;
+    static constexpr unsigned OUTPUT = 1u << 31;
+    static constexpr size_t TEDDY_LIMIT = 64;
+    static constexpr size_t TEDDY_BUCKETS = 8;
+    static constexpr size_t FINGERPRINT = 3;
+
+    unsigned char byteClass[256] = {};
+    unsigned classes = 1;
+    std::vector<unsigned> transitions;
+    std::vector<unsigned> terminal;
+    std::vector<unsigned> dictionaryLink;
+    std::vector<unsigned> samePattern;
+    std::vector<size_t> lengths;
+
+    size_t fingerprint = 0;
+    unsigned char fingerprintMask[FINGERPRINT][256] = {};
+    alignas(16) unsigned char lowNibble[FINGERPRINT][16] = {};
+    alignas(16) unsigned char highNibble[FINGERPRINT][16] = {};
+
+    unsigned addState() {
+        assert(transitions.size() + classes < OUTPUT);
+        transitions.resize(transitions.size() + classes, NONE);
+        terminal.push_back(NONE);
+        dictionaryLink.push_back(NONE);
+        return static_cast<unsigned>(terminal.size() - 1);
+    }
+
+    void buildClasses(const std::vector<StringView>& patterns) {
+        bool used[256] = {};
+        for (StringView p : patterns) {
+            for (size_t i = 0; i < p.length(); i++) {
+                used[static_cast<unsigned char>(p[i])] = true;
+            }
+        }
+        for (unsigned c = 0; c < 256; c++) {
+            if (used[c]) {
+                byteClass[c] = static_cast<unsigned char>(classes++);
+            }
+        }
+    }
+
+    void buildTrie(const std::vector<StringView>& patterns) {
+        addState();
+        samePattern.assign(patterns.size(), NONE);
+        for (size_t id = 0; id < patterns.size(); id++) {
+            StringView p = patterns[id];
+            lengths.push_back(p.length());
+            if (p.empty()) {
+                continue;
+            }
+            unsigned state = 0;
+            for (size_t i = 0; i < p.length(); i++) {
+                unsigned c = byteClass[static_cast<unsigned char>(p[i])];
+                if (transitions[state * classes + c] == NONE) {
+                    unsigned next = addState();
+                    transitions[state * classes + c] = next;
+                }
+                state = transitions[state * classes + c];
+            }
+            samePattern[id] = terminal[state];
+            terminal[state] = static_cast<unsigned>(id);
+        }
+    }
+
+    void buildLinks() {
+        std::vector<unsigned> fail(terminal.size(), 0);
+        std::vector<unsigned> queue;
+        queue.reserve(terminal.size());
+        for (unsigned c = 0; c < classes; c++) {
+            unsigned& next = transitions[c];
+            if (next == NONE) {
+                next = 0;
+            } else {
+                queue.push_back(next);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); head++) {
+            unsigned u = queue[head];
+            unsigned f = fail[u];
+            dictionaryLink[u] = terminal[f] != NONE ? f : dictionaryLink[f];
+            for (unsigned c = 0; c < classes; c++) {
+                unsigned& next = transitions[u * classes + c];
+                if (next == NONE) {
+                    next = transitions[f * classes + c];
+                } else {
+                    fail[next] = transitions[f * classes + c];
+                    queue.push_back(next);
+                }
+            }
+        }
+        for (unsigned& next : transitions) {
+            bool output = terminal[next] != NONE || dictionaryLink[next] != NONE;
+            next = next * classes | (output ? OUTPUT : 0);
+        }
+    }
+
+    void buildPrefilter(const std::vector<StringView>& patterns) {
+        if (patterns.empty() || patterns.size() > TEDDY_LIMIT) {
+            return;
+        }
+        size_t shortest = patterns[0].length();
+        for (StringView p : patterns) {
+            shortest = std::min(shortest, p.length());
+        }
+        if (shortest == 0) {
+            return;
+        }
+        fingerprint = std::min(shortest, FINGERPRINT);
+        for (size_t id = 0; id < patterns.size(); id++) {
+            unsigned char bucket = static_cast<unsigned char>(1u << (id % TEDDY_BUCKETS));
+            for (size_t k = 0; k < fingerprint; k++) {
+                unsigned char c = static_cast<unsigned char>(patterns[id][k]);
+                fingerprintMask[k][c] |= bucket;
+                lowNibble[k][c & 15] |= bucket;
+                highNibble[k][c >> 4] |= bucket;
+            }
+        }
+    }
+
+    size_t candidateScalar(const unsigned char* text, size_t n, size_t from) const {
+        for (size_t i = from; i + fingerprint <= n; i++) {
+            unsigned char buckets = fingerprintMask[0][text[i]];
+            for (size_t k = 1; k < fingerprint && buckets != 0; k++) {
+                buckets &= fingerprintMask[k][text[i + k]];
+            }
+            if (buckets != 0) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+#ifdef STRING_X86_DISPATCH
+    static bool useSsse3() {
+#if defined(__SSSE3__)
+        return true;
+#else
+        static const bool supported = __builtin_cpu_supports("ssse3");
+        return supported;
+#endif
+    }
+
+    __attribute__((target("ssse3")))
+    size_t candidateSsse3(const unsigned char* text, size_t n, size_t from) const {
+        const __m128i nibble = _mm_set1_epi8(15);
+        __m128i low[FINGERPRINT];
+        __m128i high[FINGERPRINT];
+        for (size_t k = 0; k < fingerprint; k++) {
+            low[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(lowNibble[k]));
+            high[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(highNibble[k]));
+        }
+        size_t i = from;
+        for (; i + 16 + fingerprint - 1 <= n; i += 16) {
+            __m128i buckets = _mm_set1_epi8(-1);
+            for (size_t k = 0; k < fingerprint; k++) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + k));
+                __m128i lo = _mm_shuffle_epi8(low[k], _mm_and_si128(chunk, nibble));
+                __m128i hi = _mm_shuffle_epi8(high[k], _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble));
+                buckets = _mm_and_si128(buckets, _mm_and_si128(lo, hi));
+            }
+            unsigned empty = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(buckets, _mm_setzero_si128())));
+            if (empty != 0xffff) {
+                return i + __builtin_ctz(~empty);
+            }
+        }
+        return candidateScalar(text, n, i);
+    }
+#endif
+
+    size_t nextCandidate(const unsigned char* text, size_t n, size_t from) const {
+#ifdef STRING_X86_DISPATCH
+        if (useSsse3()) {
+            return candidateSsse3(text, n, from);
+        }
+#endif
+        return candidateScalar(text, n, from);
+    }
+
+    void build(const std::vector<StringView>& patterns) {
+        buildClasses(patterns);
+        buildTrie(patterns);
+        buildLinks();
+        buildPrefilter(patterns);
+    }
+
+public:
+    explicit AhoCorasick(const std::vector<StringView>& patterns) {
+        build(patterns);
+    }
+
+    explicit AhoCorasick(const std::vector<String>& patterns) {
+        build(std::vector<StringView>(patterns.begin(), patterns.end()));
+    }
+
+    size_t patternCount() const {
+        return lengths.size();
+    }
+
+    size_t stateCount() const {
+        return terminal.size();
+    }
+
+    bool hasPrefilter() const {
+        return fingerprint != 0;
+    }
+
+    template<typename F>
+    void scan(StringView text, F f) const {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+        size_t n = text.length();
+        unsigned state = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (state == 0 && fingerprint != 0) {
+                i = nextCandidate(p, n, i);
+                if (i == n) {
+                    return;
+                }
+            }
+            unsigned next = transitions[state + byteClass[p[i]]];
+            state = next & ~OUTPUT;
+            if ((next & OUTPUT) == 0) {
+                continue;
+            }
+            unsigned s = state / classes;
+            s = terminal[s] != NONE ? s : dictionaryLink[s];
+            for (; s != NONE; s = dictionaryLink[s]) {
+                for (unsigned id = terminal[s]; id != NONE; id = samePattern[id]) {
+                    f(Match{id, i + 1 - lengths[id]});
+                }
+            }
+        }
+    }
+
+    std::vector<Match> findAll(StringView text) const {
+        std::vector<Match> res;
+        scan(text, [&res](const Match& m) { res.push_back(m); });
+        return res;
+    }
+
+    bool containsAny(StringView text) const {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+        size_t n = text.length();
+        unsigned state = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (state == 0 && fingerprint != 0) {
+                i = nextCandidate(p, n, i);
+                if (i == n) {
+                    return false;
+                }
+            }
+            unsigned next = transitions[state + byteClass[p[i]]];
+            if (next & OUTPUT) {
+                return true;
+            }
+            state = next;
+        }
+        return false;
+    }
+};
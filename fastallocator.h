@@ -1,28 +1,233 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
 #include <iostream>
 #include <list>
+#include <map>
+#include <mutex>
+#include <new>
 #include <type_traits>
+#include <utility>
 #include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FASTALLOCATOR_HAS_MADVISE 1
+#include <sys/mman.h>
+#endif
+
 using std::cin;
 using std::cout;
 using std::vector;
 
-template <size_t chunkSize>
+template <size_t chunkSize, size_t alignment = alignof(std::max_align_t)>
 class FixedAllocator {
+public:
+    struct Stats {
+        size_t live;
+        size_t free;
+        size_t reserved;
+    };
+
 private:
-    std::vector<int8_t*> blocks;
-    std::vector<int8_t*> vacant;
-    static const size_t STATIC_SIZE = 1024;
+    struct Chunk {
+        Chunk* next;
+    };
+
+    struct Slab {
+        size_t size;
+        size_t vacant;
+    };
+
+    static constexpr size_t ALIGN = std::max(alignment, alignof(Chunk));
+    static constexpr size_t STRIDE = (std::max(chunkSize, sizeof(Chunk)) + ALIGN - 1) / ALIGN * ALIGN;
+    static constexpr size_t PAGE_SIZE = 4096;
+    static constexpr size_t MIN_SLAB = (std::max(PAGE_SIZE, 16 * STRIDE) + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    static constexpr size_t MAX_SLAB = std::max(size_t(1) << 20, MIN_SLAB);
+    static constexpr size_t HUGE_SLAB = size_t(1) << 18;
+    static constexpr size_t BATCH = 32;
+
+    struct Cache {
+        Chunk* head = nullptr;
+        std::atomic<size_t> count{0};
+        std::atomic<bool> flush{false};
+
+        Cache() {
+            getAllocator().attach(this);
+        }
+
+        ~Cache() {
+            getAllocator().detach(this);
+        }
+
+        void add(size_t delta) {
+            count.store(count.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        void remove(size_t delta) {
+            count.store(count.load(std::memory_order_relaxed) - delta, std::memory_order_relaxed);
+        }
+    };
+
+    std::mutex mutex;
+    std::map<int8_t*, Slab> blocks;
+    std::vector<std::pair<int8_t*, size_t>> spare;
+    std::vector<Cache*> caches;
+    Chunk* vacant = nullptr;
+    size_t vacantCount = 0;
+    int8_t* current = nullptr;
+    int8_t* cursor = nullptr;
+    int8_t* limit = nullptr;
+    size_t slabSize = MIN_SLAB;
+    size_t carved = 0;
+    size_t reserved = 0;
+    size_t releaseThreshold = SIZE_MAX;
+    size_t nextTrim = SIZE_MAX;
+
+    static Cache& getCache() {
+        static thread_local Cache cache;
+        return cache;
+    }
+
+    void attach(Cache* cache) {
+        std::lock_guard<std::mutex> lock(mutex);
+        caches.push_back(cache);
+    }
+
+    void detach(Cache* cache) {
+        release(*cache, cache->count.load(std::memory_order_relaxed));
+        std::lock_guard<std::mutex> lock(mutex);
+        caches.erase(std::find(caches.begin(), caches.end(), cache));
+    }
 
-    size_t cnt = 0;
-    
     void newBlock() {
-        int8_t* last = new int8_t[STATIC_SIZE];
-        blocks.push_back(last);
-        cnt = 0;
+        int8_t* last;
+        size_t size;
+        if (!spare.empty()) {
+            last = spare.back().first;
+            size = spare.back().second;
+            spare.pop_back();
+        } else {
+            size = slabSize;
+            last = static_cast<int8_t*>(::operator new(size, std::align_val_t(ALIGN)));
+            slabSize = std::min(2 * slabSize, MAX_SLAB);
+        }
+        blocks.emplace(last, Slab{size, 0});
+        reserved += size;
+        current = cursor = last;
+        limit = last + size;
+    }
+
+    void dropBlock(int8_t* start, size_t size) {
+        reserved -= size;
+        if (size < HUGE_SLAB) {
+            ::operator delete(start, std::align_val_t(ALIGN));
+            return;
+        }
+#ifdef FASTALLOCATOR_HAS_MADVISE
+        uintptr_t from = (reinterpret_cast<uintptr_t>(start) + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+        uintptr_t to = (reinterpret_cast<uintptr_t>(start) + size) / PAGE_SIZE * PAGE_SIZE;
+        if (from < to) {
+            madvise(reinterpret_cast<void*>(from), to - from, MADV_DONTNEED);
+        }
+#endif
+        spare.emplace_back(start, size);
+    }
+
+    void flushCache(Cache& cache) {
+        cache.flush.store(false, std::memory_order_relaxed);
+        release(cache, cache.count.load(std::memory_order_relaxed));
+        std::lock_guard<std::mutex> lock(mutex);
+        trimLocked();
+    }
+
+    size_t trimLocked() {
+        for (auto& block : blocks) {
+            block.second.vacant = 0;
+        }
+        for (Chunk* chunk = vacant; chunk != nullptr; chunk = chunk->next) {
+            auto it = --blocks.upper_bound(reinterpret_cast<int8_t*>(chunk));
+            it->second.vacant++;
+        }
+        auto isEmpty = [this](int8_t* start, const Slab& slab) {
+            size_t used = start == current ? static_cast<size_t>(cursor - start) : slab.size;
+            return slab.vacant == used / STRIDE;
+        };
+        Chunk** link = &vacant;
+        while (*link != nullptr) {
+            auto it = --blocks.upper_bound(reinterpret_cast<int8_t*>(*link));
+            if (isEmpty(it->first, it->second)) {
+                *link = (*link)->next;
+                vacantCount--;
+            } else {
+                link = &(*link)->next;
+            }
+        }
+        size_t released = 0;
+        for (auto it = blocks.begin(); it != blocks.end();) {
+            if (!isEmpty(it->first, it->second)) {
+                ++it;
+                continue;
+            }
+            if (it->first == current) {
+                carved -= static_cast<size_t>(cursor - current) / STRIDE;
+                current = cursor = limit = nullptr;
+            } else {
+                carved -= it->second.size / STRIDE;
+            }
+            released += it->second.size;
+            dropBlock(it->first, it->second.size);
+            it = blocks.erase(it);
+        }
+        nextTrim = releaseThreshold == SIZE_MAX ? SIZE_MAX : vacantCount * STRIDE + releaseThreshold;
+        return released;
     }
 
-    FixedAllocator() {
-        newBlock();
+    FixedAllocator() {}
+
+    void refill(Cache& cache) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t taken = 0;
+        while (taken < BATCH && vacant != nullptr) {
+            Chunk* chunk = vacant;
+            vacant = chunk->next;
+            chunk->next = cache.head;
+            cache.head = chunk;
+            taken++;
+        }
+        vacantCount -= taken;
+        while (taken < BATCH) {
+            if (static_cast<size_t>(limit - cursor) < STRIDE) {
+                newBlock();
+            }
+            Chunk* chunk = reinterpret_cast<Chunk*>(cursor);
+            cursor += STRIDE;
+            chunk->next = cache.head;
+            cache.head = chunk;
+            carved++;
+            taken++;
+        }
+        cache.add(taken);
+    }
+
+    void release(Cache& cache, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        Chunk* first = cache.head;
+        Chunk* last = first;
+        for (size_t i = 1; i < count; i++) {
+            last = last->next;
+        }
+        cache.head = last->next;
+        cache.remove(count);
+        std::lock_guard<std::mutex> lock(mutex);
+        last->next = vacant;
+        vacant = first;
+        vacantCount += count;
+        if (vacantCount * STRIDE >= nextTrim) {
+            trimLocked();
+        }
     }
 
 public:
@@ -32,28 +237,134 @@ public:
     }
 
     void* allocate() {
-        if (cnt + chunkSize > STATIC_SIZE && vacant.empty()) {
-            newBlock();
+        Cache& cache = getCache();
+        if (cache.flush.load(std::memory_order_relaxed)) {
+            flushCache(cache);
         }
-        int8_t* ans;
-        if (!vacant.empty()) {
-            ans = vacant.back();
-            vacant.pop_back();
-        } else {
-            ans = blocks.back() + cnt;
-            cnt += chunkSize;
+        if (cache.head == nullptr) {
+            refill(cache);
         }
-        return static_cast<void*>(ans); 
+        Chunk* ans = cache.head;
+        cache.head = ans->next;
+        cache.remove(1);
+        return static_cast<void*>(ans);
     }
 
     void deallocate(void* ptr) {
-        vacant.push_back(static_cast<int8_t*>(ptr));    
+        Cache& cache = getCache();
+        Chunk* chunk = static_cast<Chunk*>(ptr);
+        chunk->next = cache.head;
+        cache.head = chunk;
+        cache.add(1);
+        if (cache.flush.load(std::memory_order_relaxed)) {
+            flushCache(cache);
+        } else if (cache.count.load(std::memory_order_relaxed) >= 2 * BATCH) {
+            release(cache, BATCH);
+        }
+    }
+
+    size_t trim() {
+        Cache& cache = getCache();
+        cache.flush.store(false, std::memory_order_relaxed);
+        release(cache, cache.count.load(std::memory_order_relaxed));
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Cache* other : caches) {
+            if (other != &cache && other->count.load(std::memory_order_relaxed) != 0) {
+                other->flush.store(true, std::memory_order_relaxed);
+            }
+        }
+        return trimLocked();
+    }
+
+    void setReleaseThreshold(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        releaseThreshold = bytes;
+        nextTrim = bytes == SIZE_MAX ? SIZE_MAX : vacantCount * STRIDE + bytes;
+    }
+
+    Stats stats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t idle = vacantCount;
+        for (Cache* cache : caches) {
+            idle += cache->count.load(std::memory_order_relaxed);
+        }
+        size_t live = (carved - idle) * STRIDE;
+        return Stats{live, reserved - live, reserved};
     }
 
     ~FixedAllocator() {
-        for (auto b : blocks) {
-            ::operator delete(b);   
-        }    
+        for (auto& block : blocks) {
+            ::operator delete(block.first, std::align_val_t(ALIGN));
+        }
+        for (auto& block : spare) {
+            ::operator delete(block.first, std::align_val_t(ALIGN));
+        }
+    }
+};
+
+class SizeClasses {
+public:
+    static constexpr size_t COUNT = 29;
+    static constexpr size_t MAX_SIZE = 4096;
+
+    static constexpr size_t index(size_t bytes) {
+        if (bytes <= 8) {
+            return 0;
+        }
+        if (bytes <= 128) {
+            return (bytes + 15) / 16;
+        }
+        size_t exponent = 0;
+        while ((size_t(2) << exponent) < bytes) {
+            exponent++;
+        }
+        return 9 + (exponent - 7) * 4 + ((bytes - 1) >> (exponent - 2)) - 4;
+    }
+
+    static constexpr size_t size(size_t index) {
+        if (index == 0) {
+            return 8;
+        }
+        if (index <= 8) {
+            return 16 * index;
+        }
+        size_t exponent = 7 + (index - 9) / 4;
+        return (size_t(1) << exponent) + ((index - 9) % 4 + 1) * (size_t(1) << (exponent - 2));
+    }
+
+    static constexpr size_t align(size_t index) {
+        return std::min(alignof(std::max_align_t), size(index) & (~size(index) + 1));
+    }
+
+private:
+    template<size_t I>
+    static void* allocateClass() {
+        return FixedAllocator<size(I), align(I)>::getAllocator().allocate();
+    }
+
+    template<size_t I>
+    static void deallocateClass(void* ptr) {
+        FixedAllocator<size(I), align(I)>::getAllocator().deallocate(ptr);
+    }
+
+    template<typename Sequence>
+    struct Table;
+
+    template<size_t... I>
+    struct Table<std::index_sequence<I...>> {
+        static constexpr void* (*allocators[])() = {&allocateClass<I>...};
+        static constexpr void (*deallocators[])(void*) = {&deallocateClass<I>...};
+    };
+
+    using Classes = Table<std::make_index_sequence<COUNT>>;
+
+public:
+    static void* allocate(size_t bytes) {
+        return Classes::allocators[index(bytes)]();
+    }
+
+    static void deallocate(void* ptr, size_t bytes) {
+        Classes::deallocators[index(bytes)](ptr);
     }
 };
 
@@ -65,6 +376,7 @@ public:
         typedef FastAllocator<U> other;
     };
     using value_type = T;
+    using is_always_equal = std::true_type;
 
     FastAllocator<T>() = default;
     FastAllocator<T>(const FastAllocator<T>&) = default;
@@ -73,18 +385,27 @@ public:
     FastAllocator(const FastAllocator<U>&) {}
 
     T* allocate(size_t size) {
-        if (size == 1) {
-            return static_cast<T*>(FixedAllocator<sizeof(T)>::getAllocator().allocate());
+        if constexpr (alignof(T) <= alignof(std::max_align_t)) {
+            if (size <= SizeClasses::MAX_SIZE / sizeof(T)) {
+                return static_cast<T*>(SizeClasses::allocate(size * sizeof(T)));
+            }
+        } else if (size == 1) {
+            return static_cast<T*>(FixedAllocator<sizeof(T), alignof(T)>::getAllocator().allocate());
         }
         return std::allocator<T>().allocate(size);
     }
 
     void deallocate(T* ptr, size_t size) {
-        if (size == 1) {
-            FixedAllocator<sizeof(T)>::getAllocator().deallocate(static_cast<void*>(ptr));
-        } else {
-            std::allocator<T>().deallocate(ptr, size);
+        if constexpr (alignof(T) <= alignof(std::max_align_t)) {
+            if (size <= SizeClasses::MAX_SIZE / sizeof(T)) {
+                SizeClasses::deallocate(static_cast<void*>(ptr), size * sizeof(T));
+                return;
+            }
+        } else if (size == 1) {
+            FixedAllocator<sizeof(T), alignof(T)>::getAllocator().deallocate(static_cast<void*>(ptr));
+            return;
         }
+        std::allocator<T>().deallocate(ptr, size);
     }
 
     template<typename... Args>
@@ -99,8 +420,8 @@ public:
 };
 
 template<typename T, typename U>
-bool operator == (const FastAllocator<T>& a, const FastAllocator<U>& b) {
-    return &a == &b;
+bool operator == (const FastAllocator<T>&, const FastAllocator<U>&) {
+    return true;
 }
 
 template<typename T, typename U>
@@ -108,6 +429,157 @@ bool operator !=(const FastAllocator<T>& a, const FastAllocator<U>& b) {
     return !(a == b);
 }
 
+class Arena {
+private:
+    struct Block {
+        Block* prev;
+        size_t size;
+    };
+
+    struct Vacant {
+        Vacant* next;
+    };
+
+    static constexpr size_t HEADER = (sizeof(Block) + alignof(std::max_align_t) - 1) /
+                                     alignof(std::max_align_t) * alignof(std::max_align_t);
+    static constexpr size_t MAX_BLOCK = size_t(1) << 20;
+
+    Block* blocks = nullptr;
+    uintptr_t cursor = 0;
+    uintptr_t limit = 0;
+    size_t blockSize;
+    size_t initialSize;
+    size_t reservedBytes = 0;
+    bool recycle;
+    Vacant* vacant[SizeClasses::COUNT] = {};
+
+    void grow(size_t bytes) {
+        size_t size = std::max(blockSize, HEADER + bytes);
+        Block* block = static_cast<Block*>(::operator new(size));
+        block->prev = blocks;
+        block->size = size;
+        blocks = block;
+        cursor = reinterpret_cast<uintptr_t>(block) + HEADER;
+        limit = reinterpret_cast<uintptr_t>(block) + size;
+        reservedBytes += size;
+        blockSize = std::min(2 * blockSize, std::max(MAX_BLOCK, initialSize));
+    }
+
+    bool recyclable(size_t bytes, size_t align) const {
+        return recycle && bytes <= SizeClasses::MAX_SIZE && align <= SizeClasses::align(SizeClasses::index(bytes));
+    }
+
+public:
+    explicit Arena(bool recycle = false, size_t initialSize = 4096)
+            : blockSize(initialSize), initialSize(initialSize), recycle(recycle) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator = (const Arena&) = delete;
+
+    ~Arena() {
+        release();
+    }
+
+    void* allocate(size_t bytes, size_t align) {
+        if (recyclable(bytes, align)) {
+            size_t index = SizeClasses::index(bytes);
+            if (vacant[index] != nullptr) {
+                Vacant* res = vacant[index];
+                vacant[index] = res->next;
+                return res;
+            }
+            bytes = SizeClasses::size(index);
+            align = SizeClasses::align(index);
+        }
+        uintptr_t res = (cursor + align - 1) & ~(align - 1);
+        if (blocks == nullptr || res + bytes > limit) {
+            grow(bytes + align);
+            res = (cursor + align - 1) & ~(align - 1);
+        }
+        cursor = res + bytes;
+        return reinterpret_cast<void*>(res);
+    }
+
+    void deallocate(void* ptr, size_t bytes, size_t align) {
+        if (recyclable(bytes, align)) {
+            size_t index = SizeClasses::index(bytes);
+            Vacant* chunk = static_cast<Vacant*>(ptr);
+            chunk->next = vacant[index];
+            vacant[index] = chunk;
+        }
+    }
+
+    void release() {
+        while (blocks != nullptr) {
+            Block* prev = blocks->prev;
+            ::operator delete(blocks);
+            blocks = prev;
+        }
+        cursor = limit = 0;
+        blockSize = initialSize;
+        reservedBytes = 0;
+        std::fill(vacant, vacant + SizeClasses::COUNT, nullptr);
+    }
+
+    size_t reserved() const {
+        return reservedBytes;
+    }
+};
+
+template<typename T>
+class ArenaAllocator {
+private:
+    Arena* arena;
+
+public:
+    template<typename U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    ArenaAllocator(Arena* arena) : arena(arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.getArena()) {}
+
+    Arena* getArena() const {
+        return arena;
+    }
+
+    T* allocate(size_t size) {
+        return static_cast<T*>(arena->allocate(size * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t size) {
+        arena->deallocate(static_cast<void*>(ptr), size * sizeof(T), alignof(T));
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) {
+        new (ptr) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void destroy(U* ptr) {
+        ptr->~U();
+    }
+};
+
+template<typename T, typename U>
+bool operator == (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+
+template<typename T, typename U>
+bool operator !=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return !(a == b);
+}
+
 //template <typename T, typename Allocator = std::allocator<T>>
 //using List = std::list<T, Allocator>;
 
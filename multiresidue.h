@@ -0,0 +1,166 @@
+#pragma once
+#include <string>
+#include <tuple>
+#include <utility>
+#include "biginteger.h"
+#include "residue.h"
+
+constexpr bool pairwiseCoprime(const unsigned* moduli, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < i; j++) {
+            unsigned long long a = moduli[i], b = moduli[j];
+            while (b) {
+                unsigned long long t = a % b;
+                a = b;
+                b = t;
+            }
+            if (a != 1) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<unsigned... Ns>
+class MultiResidue {
+private:
+    static constexpr size_t K = sizeof...(Ns);
+    static constexpr unsigned moduli[K] = {Ns...};
+
+    static_assert(K > 0, "MultiResidue needs at least one modulus");
+    static_assert(pairwiseCoprime(moduli, K), "MultiResidue moduli must be pairwise coprime");
+
+    struct GarnerTable {
+        unsigned long long inv[K][K] = {};
+    };
+
+    static constexpr GarnerTable makeGarnerTable() {
+        GarnerTable table;
+        for (size_t i = 0; i < K; i++) {
+            for (size_t j = 0; j < i; j++) {
+                table.inv[i][j] = inverseMod(moduli[j], moduli[i]);
+            }
+        }
+        return table;
+    }
+
+    using Indices = std::index_sequence_for<Residue<Ns>...>;
+
+    std::tuple<Residue<Ns>...> parts;
+
+    template<typename F, size_t... I>
+    void zip(const MultiResidue& other, F f, std::index_sequence<I...>) {
+        (f(std::get<I>(parts), std::get<I>(other.parts)), ...);
+    }
+
+    template<size_t... I>
+    void values(unsigned long long* res, std::index_sequence<I...>) const {
+        ((res[I] = static_cast<unsigned>(static_cast<int>(std::get<I>(parts)))), ...);
+    }
+
+    template<size_t... I>
+    static std::tuple<Residue<Ns>...> fromString(const std::string& s, std::index_sequence<I...>) {
+        unsigned long long res[K] = {};
+        bool negative = !s.empty() && s[0] == '-';
+        for (size_t i = negative ? 1 : 0; i < s.size(); i++) {
+            for (size_t j = 0; j < K; j++) {
+                res[j] = (res[j] * 10 + static_cast<unsigned>(s[i] - '0')) % moduli[j];
+            }
+        }
+        return std::tuple<Residue<Ns>...>(Residue<Ns>(negative ? -static_cast<long long>(res[I])
+                                                               : static_cast<long long>(res[I]))...);
+    }
+
+public:
+    MultiResidue() = default;
+
+    explicit MultiResidue(long long val) : parts(Residue<Ns>(val)...) {}
+
+    explicit MultiResidue(const BigInteger& val) : parts(fromString(val.toString(), Indices())) {}
+
+    template<size_t I>
+    const auto& get() const {
+        return std::get<I>(parts);
+    }
+
+    static BigInteger modulus() {
+        BigInteger res = 1;
+        for (size_t i = 0; i < K; i++) {
+            res *= BigInteger(static_cast<long long>(moduli[i]));
+        }
+        return res;
+    }
+
+    bool operator == (const MultiResidue& other) const {
+        return parts == other.parts;
+    }
+
+    bool operator != (const MultiResidue& other) const {
+        return !(parts == other.parts);
+    }
+
+    MultiResidue& operator += (const MultiResidue& right) {
+        zip(right, [](auto& a, const auto& b) { a += b; }, Indices());
+        return *this;
+    }
+
+    MultiResidue& operator -= (const MultiResidue& right) {
+        zip(right, [](auto& a, const auto& b) { a -= b; }, Indices());
+        return *this;
+    }
+
+    MultiResidue& operator *= (const MultiResidue& right) {
+        zip(right, [](auto& a, const auto& b) { a *= b; }, Indices());
+        return *this;
+    }
+
+    BigInteger toBigInteger() const {
+        static constexpr GarnerTable table = makeGarnerTable();
+        unsigned long long digits[K];
+        values(digits, Indices());
+        for (size_t i = 1; i < K; i++) {
+            unsigned long long x = digits[i];
+            for (size_t j = 0; j < i; j++) {
+                x = (x + moduli[i] - digits[j] % moduli[i]) % moduli[i] * table.inv[i][j] % moduli[i];
+            }
+            digits[i] = x;
+        }
+        BigInteger res = static_cast<long long>(digits[K - 1]);
+        for (size_t i = K - 1; i-- > 0;) {
+            res *= BigInteger(static_cast<long long>(moduli[i]));
+            res += BigInteger(static_cast<long long>(digits[i]));
+        }
+        return res;
+    }
+
+    BigInteger toSignedBigInteger() const {
+        BigInteger res = toBigInteger();
+        BigInteger mod = modulus();
+        if (mod < res * 2) {
+            res -= mod;
+        }
+        return res;
+    }
+};
+
+template<unsigned... Ns>
+MultiResidue<Ns...> operator + (const MultiResidue<Ns...>& left, const MultiResidue<Ns...>& right) {
+    MultiResidue<Ns...> ans = left;
+    ans += right;
+    return ans;
+}
+
+template<unsigned... Ns>
+MultiResidue<Ns...> operator - (const MultiResidue<Ns...>& left, const MultiResidue<Ns...>& right) {
+    MultiResidue<Ns...> ans = left;
+    ans -= right;
+    return ans;
+}
+
+template<unsigned... Ns>
+MultiResidue<Ns...> operator * (const MultiResidue<Ns...>& left, const MultiResidue<Ns...>& right) {
+    MultiResidue<Ns...> ans = left;
+    ans *= right;
+    return ans;
+}
@@ -0,0 +1,329 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "residue.h"
+
+template<unsigned N>
+class NTT {
+private:
+    static_assert(is_prime_v<N>, "NTT needs a prime modulus");
+
+    using Value = Residue<N>;
+
+    static constexpr size_t BLOCK = 1 << 12;
+
+    std::vector<Value> roots;
+    std::vector<Value> inverseRoots;
+
+    static unsigned twoAdicity() {
+        unsigned k = 0;
+        unsigned m = N - 1;
+        while (m % 2 == 0) {
+            m /= 2;
+            k++;
+        }
+        return k;
+    }
+
+    void grow(size_t n) {
+        if (roots.size() >= n) {
+            return;
+        }
+        assert(n <= maxSize());
+        if (roots.empty()) {
+            roots.assign(2, Value(1));
+            inverseRoots.assign(2, Value(1));
+        }
+        size_t half = roots.size();
+        roots.resize(n);
+        inverseRoots.resize(n);
+        for (; half < n; half *= 2) {
+            Value w = Value::getPrimitiveRoot().pow((N - 1) / (2 * half));
+            Value wInv = w.getInverse();
+            roots[half] = inverseRoots[half] = Value(1);
+            for (size_t j = 1; j < half; j++) {
+                roots[half + j] = roots[half + j - 1] * w;
+                inverseRoots[half + j] = inverseRoots[half + j - 1] * wInv;
+            }
+        }
+    }
+
+    void forwardStage(Value* a, size_t n, size_t half) const {
+        const Value* w = roots.data() + half;
+        for (size_t i = 0; i < n; i += 2 * half) {
+            for (size_t j = 0; j < half; j++) {
+                Value u = a[i + j];
+                Value v = a[i + j + half];
+                a[i + j] = u + v;
+                a[i + j + half] = (u - v) * w[j];
+            }
+        }
+    }
+
+    void inverseStage(Value* a, size_t n, size_t half) const {
+        const Value* w = inverseRoots.data() + half;
+        for (size_t i = 0; i < n; i += 2 * half) {
+            for (size_t j = 0; j < half; j++) {
+                Value u = a[i + j];
+                Value v = a[i + j + half] * w[j];
+                a[i + j] = u + v;
+                a[i + j + half] = u - v;
+            }
+        }
+    }
+
+public:
+    static size_t maxSize() {
+        return size_t(1) << twoAdicity();
+    }
+
+    static NTT& instance() {
+        static thread_local NTT ntt;
+        return ntt;
+    }
+
+    void forward(Value* a, size_t n) {
+        grow(n);
+        size_t half = n / 2;
+        for (; half >= BLOCK; half /= 2) {
+            forwardStage(a, n, half);
+        }
+        size_t block = std::min(n, BLOCK);
+        for (size_t start = 0; start < n; start += block) {
+            for (size_t h = half; h >= 1; h /= 2) {
+                forwardStage(a + start, block, h);
+            }
+        }
+    }
+
+    void inverse(Value* a, size_t n) {
+        grow(n);
+        size_t block = std::min(n, BLOCK);
+        for (size_t start = 0; start < n; start += block) {
+            for (size_t h = 1; h < block; h *= 2) {
+                inverseStage(a + start, block, h);
+            }
+        }
+        for (size_t half = block; half < n; half *= 2) {
+            inverseStage(a, n, half);
+        }
+        Value nInv = Value(static_cast<long long>(n)).getInverse();
+        for (size_t i = 0; i < n; i++) {
+            a[i] *= nInv;
+        }
+    }
+
+    std::vector<Value> multiply(std::vector<Value> a, std::vector<Value> b) {
+        if (a.empty() || b.empty()) {
+            return {};
+        }
+        size_t resultSize = a.size() + b.size() - 1;
+        if (std::min(a.size(), b.size()) <= 32) {
+            std::vector<Value> res(resultSize, Value(0));
+            for (size_t i = 0; i < a.size(); i++) {
+                for (size_t j = 0; j < b.size(); j++) {
+                    res[i + j] += a[i] * b[j];
+                }
+            }
+            return res;
+        }
+        size_t n = 1;
+        while (n < resultSize) {
+            n *= 2;
+        }
+        a.resize(n, Value(0));
+        b.resize(n, Value(0));
+        forward(a.data(), n);
+        forward(b.data(), n);
+        ResidueBatch<N>::mul(a.data(), a.data(), b.data(), n);
+        inverse(a.data(), n);
+        a.resize(resultSize);
+        return a;
+    }
+};
+
+template<unsigned N>
+class Polynomial {
+private:
+    using Value = Residue<N>;
+
+    std::vector<Value> coeffs;
+
+    void normalize() {
+        while (!coeffs.empty() && coeffs.back() == Value(0)) {
+            coeffs.pop_back();
+        }
+    }
+
+    Polynomial truncated(size_t k) const {
+        return Polynomial(std::vector<Value>(coeffs.begin(),
+                                             coeffs.begin() + std::min(k, coeffs.size())));
+    }
+
+    Polynomial reversed(size_t k) const {
+        std::vector<Value> res(k, Value(0));
+        for (size_t i = 0; i < std::min(k, coeffs.size()); i++) {
+            res[k - 1 - i] = coeffs[i];
+        }
+        return Polynomial(res);
+    }
+
+    static Polynomial buildTree(std::vector<Polynomial>& tree, size_t v, const std::vector<Value>& points,
+                                size_t l, size_t r) {
+        if (r - l == 1) {
+            tree[v] = Polynomial({Value(0) - points[l], Value(1)});
+        } else {
+            size_t m = (l + r) / 2;
+            tree[v] = buildTree(tree, 2 * v, points, l, m) * buildTree(tree, 2 * v + 1, points, m, r);
+        }
+        return tree[v];
+    }
+
+    static void evaluateTree(const std::vector<Polynomial>& tree, size_t v, const Polynomial& p,
+                             const std::vector<Value>& points, size_t l, size_t r, std::vector<Value>& res) {
+        if (r - l <= 32) {
+            for (size_t i = l; i < r; i++) {
+                res[i] = p(points[i]);
+            }
+            return;
+        }
+        size_t m = (l + r) / 2;
+        evaluateTree(tree, 2 * v, p % tree[2 * v], points, l, m, res);
+        evaluateTree(tree, 2 * v + 1, p % tree[2 * v + 1], points, m, r, res);
+    }
+
+public:
+    Polynomial() = default;
+
+    Polynomial(std::vector<Value> c) : coeffs(std::move(c)) {
+        normalize();
+    }
+
+    Polynomial(std::initializer_list<Value> c) : coeffs(c) {
+        normalize();
+    }
+
+    int degree() const {
+        return static_cast<int>(coeffs.size()) - 1;
+    }
+
+    size_t size() const {
+        return coeffs.size();
+    }
+
+    Value operator[](size_t i) const {
+        return i < coeffs.size() ? coeffs[i] : Value(0);
+    }
+
+    const std::vector<Value>& coefficients() const {
+        return coeffs;
+    }
+
+    Value operator()(const Value& x) const {
+        Value res(0);
+        for (size_t i = coeffs.size(); i-- > 0;) {
+            res = res * x + coeffs[i];
+        }
+        return res;
+    }
+
+    Polynomial& operator += (const Polynomial& right) {
+        coeffs.resize(std::max(coeffs.size(), right.coeffs.size()), Value(0));
+        ResidueBatch<N>::add(coeffs.data(), coeffs.data(), right.coeffs.data(), right.coeffs.size());
+        normalize();
+        return *this;
+    }
+
+    Polynomial& operator -= (const Polynomial& right) {
+        coeffs.resize(std::max(coeffs.size(), right.coeffs.size()), Value(0));
+        ResidueBatch<N>::sub(coeffs.data(), coeffs.data(), right.coeffs.data(), right.coeffs.size());
+        normalize();
+        return *this;
+    }
+
+    Polynomial& operator *= (const Polynomial& right) {
+        coeffs = NTT<N>::instance().multiply(std::move(coeffs), right.coeffs);
+        normalize();
+        return *this;
+    }
+
+    Polynomial inverse(size_t k) const {
+        assert(!coeffs.empty() && coeffs[0] != Value(0));
+        Polynomial res({coeffs[0].getInverse()});
+        for (size_t len = 1; len < k; len *= 2) {
+            Polynomial correction = (truncated(2 * len) * res).truncated(2 * len);
+            correction = Polynomial({Value(2)}) - correction;
+            res = (res * correction).truncated(2 * len);
+        }
+        return res.truncated(k);
+    }
+
+    std::pair<Polynomial, Polynomial> divmod(const Polynomial& divisor) const {
+        assert(!divisor.coeffs.empty());
+        if (degree() < divisor.degree()) {
+            return {Polynomial(), *this};
+        }
+        size_t k = static_cast<size_t>(degree() - divisor.degree()) + 1;
+        Polynomial quotient = (reversed(coeffs.size()).truncated(k) *
+                               divisor.reversed(divisor.size()).inverse(k)).truncated(k);
+        quotient = quotient.reversed(k);
+        Polynomial remainder = *this - divisor * quotient;
+        return {quotient, remainder};
+    }
+
+    Polynomial& operator /= (const Polynomial& right) {
+        *this = divmod(right).first;
+        return *this;
+    }
+
+    Polynomial& operator %= (const Polynomial& right) {
+        *this = divmod(right).second;
+        return *this;
+    }
+
+    std::vector<Value> evaluate(const std::vector<Value>& points) const {
+        std::vector<Value> res(points.size(), Value(0));
+        if (points.empty()) {
+            return res;
+        }
+        std::vector<Polynomial> tree(4 * points.size());
+        buildTree(tree, 1, points, 0, points.size());
+        evaluateTree(tree, 1, *this % tree[1], points, 0, points.size(), res);
+        return res;
+    }
+};
+
+template<unsigned N>
+Polynomial<N> operator + (const Polynomial<N>& left, const Polynomial<N>& right) {
+    Polynomial<N> ans = left;
+    ans += right;
+    return ans;
+}
+
+template<unsigned N>
+Polynomial<N> operator - (const Polynomial<N>& left, const Polynomial<N>& right) {
+    Polynomial<N> ans = left;
+    ans -= right;
+    return ans;
+}
+
+template<unsigned N>
+Polynomial<N> operator * (const Polynomial<N>& left, const Polynomial<N>& right) {
+    Polynomial<N> ans = left;
+    ans *= right;
+    return ans;
+}
+
+template<unsigned N>
+Polynomial<N> operator / (const Polynomial<N>& left, const Polynomial<N>& right) {
+    Polynomial<N> ans = left;
+    ans /= right;
+    return ans;
+}
+
+template<unsigned N>
+Polynomial<N> operator % (const Polynomial<N>& left, const Polynomial<N>& right) {
+    Polynomial<N> ans = left;
+    ans %= right;
+    return ans;
+}
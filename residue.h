@@ -1,26 +1,33 @@
+#pragma once
 #include <iostream>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <utility>
 #include <vector>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <type_traits>
 
-template<unsigned N, unsigned ANS, unsigned D>
-struct helperMinimalDivisor {
-    static const unsigned value = helperMinimalDivisor<N, N % D == 0 ? D : ANS, D - 1>::value; 
-};
-
-template<unsigned N, unsigned ANS>
-struct helperMinimalDivisor<N, ANS, 1> {
-    static const unsigned value = ANS;  
-};
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RESIDUE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
 
-template<unsigned N>
-struct squareRoot {
-    static const unsigned value = static_cast<unsigned>(sqrt(static_cast<double>(N)) + 0.5);
-};
+constexpr unsigned smallestDivisor(unsigned n) {
+    for (unsigned long long d = 2; d * d <= n; d++) {
+        if (n % d == 0) {
+            return static_cast<unsigned>(d);
+        }
+    }
+    return n;
+}
 
 template<unsigned N>
 struct minimalDivisor {
-    static const unsigned value = helperMinimalDivisor<N, N, squareRoot<N>::value>::value;
+    static const unsigned value = smallestDivisor(N);
 };
 
 template<unsigned N>
@@ -91,10 +98,111 @@ const bool is_prime_v = is_prime<N>::value;
 template<unsigned N>
 const bool has_primitive_root_v = has_primitive_root<N>::value;
 
+template<unsigned N>
+struct residueStorage {
+    using type = std::conditional_t<(N <= (1u << 8)), uint8_t,
+                 std::conditional_t<(N <= (1u << 16)), uint16_t, uint32_t>>;
+};
+
+template<unsigned N>
+using residue_storage_t = typename residueStorage<N>::type;
+
+struct primeDivisorList {
+    unsigned primes[10] = {};
+    unsigned count = 0;
+};
+
+constexpr primeDivisorList primeDivisors(unsigned n) {
+    primeDivisorList res;
+    for (unsigned long long i = 2; i * i <= n; i++) {
+        if (n % i == 0) {
+            while (n % i == 0) {
+                n /= static_cast<unsigned>(i);
+            }
+            res.primes[res.count++] = static_cast<unsigned>(i);
+        }
+    }
+    if (n > 1) {
+        res.primes[res.count++] = n;
+    }
+    return res;
+}
+
+constexpr unsigned functionEuler(unsigned n) {
+    primeDivisorList divisors = primeDivisors(n);
+    unsigned ans = n;
+    for (unsigned i = 0; i < divisors.count; i++) {
+        ans -= ans / divisors.primes[i];
+    }
+    return ans;
+}
+
+constexpr unsigned long long powMod(unsigned long long a, unsigned long long p, unsigned n) {
+    unsigned long long ans = 1 % n;
+    a %= n;
+    while (p) {
+        if (p % 2) {
+            ans = ans * a % n;
+        }
+        p /= 2;
+        a = a * a % n;
+    }
+    return ans;
+}
+
+constexpr unsigned long long inverseMod(unsigned long long a, unsigned long long n) {
+    long long r0 = static_cast<long long>(n), r1 = static_cast<long long>(a % n);
+    long long x0 = 0, x1 = 1;
+    while (r1) {
+        long long q = r0 / r1;
+        long long t = r0 - q * r1;
+        r0 = r1;
+        r1 = t;
+        t = x0 - q * x1;
+        x0 = x1;
+        x1 = t;
+    }
+    return static_cast<unsigned long long>(x0 < 0 ? x0 + static_cast<long long>(n) : x0) % n;
+}
+
+constexpr unsigned findPrimitiveRoot(unsigned n) {
+    if (n == 2) {
+        return 1;
+    }
+    unsigned phi = functionEuler(n);
+    primeDivisorList divisors = primeDivisors(phi);
+    for (unsigned long long g = 2; g < n; g++) {
+        bool flag = powMod(g, phi, n) == 1;
+        for (unsigned i = 0; flag && i < divisors.count; i++) {
+            if (powMod(g, phi / divisors.primes[i], n) == 1) {
+                flag = false;
+            }
+        }
+        if (flag) {
+            return static_cast<unsigned>(g);
+        }
+    }
+    return 0;
+}
+
+template<unsigned N>
+struct primitive_root {
+    static constexpr unsigned value = has_primitive_root_v<N> ? findPrimitiveRoot(N) : 0;
+};
+
+template<unsigned N>
+const unsigned primitive_root_v = primitive_root<N>::value;
+
+template<unsigned N>
+class ResidueBatch;
+
 template <unsigned N>
 class Residue {
 private:
-    long long value = 0;
+    using storage = residue_storage_t<N>;
+    using wide = unsigned long long;
+
+    storage value = 0;
 
     static long long gcd(long long a, long long b) {
         if (b == 0) {
@@ -103,50 +211,41 @@ private:
         return gcd(b, a % b);
     }
 
-    static std::vector<unsigned> primeDivisors(unsigned n) {
-        std::vector<unsigned> res;
-        for (unsigned i = 2; i * i <= n; i++) {
-            if (n % i == 0) {
-                while (n % i == 0) {
-                    n /= i;
-                }
-                res.push_back(i);
-            }
-        }
-        if (n > 1) {
-            res.push_back(n);
-        }
-        return res;
-    }
+    static constexpr unsigned funcEuler = functionEuler(N);
+    static constexpr primeDivisorList phiDivisors = primeDivisors(funcEuler);
 
-    static unsigned functionEuler(unsigned n) {
-        unsigned ans = n;
-        for (auto u : primeDivisors(n)) {
-            ans -= ans / u;
-        }
-        return ans;
-    }
+    friend class ResidueBatch<N>;
 public:
-    explicit Residue<N>(long long val) : value((val % N + N) % N) {}
+    Residue() = default;
+
+    explicit Residue<N>(long long val) : value(static_cast<storage>((val % N + N) % N)) {}
 
     explicit operator int() const {
         return static_cast<int>(value);
     }
 
+    bool operator == (const Residue<N>& other) const {
+        return value == other.value;
+    }
+
+    bool operator != (const Residue<N>& other) const {
+        return value != other.value;
+    }
+
     Residue<N>& operator += (const Residue<N>& left) {
-        value += left.value;
-        value %= N;
+        wide sum = static_cast<wide>(value) + left.value;
+        value = static_cast<storage>(sum >= N ? sum - N : sum);
         return *this;
     }
 
     Residue<N>& operator -= (const Residue<N>& left) {
-        *this += Residue(-left.value);
+        wide diff = static_cast<wide>(value) + N - left.value;
+        value = static_cast<storage>(diff >= N ? diff - N : diff);
         return *this;
     }
 
     Residue<N>& operator *= (const Residue<N>& left) {
-        value *= left.value;
-        value %= N;
+        value = static_cast<storage>(static_cast<wide>(value) * left.value % N);
         return *this;
     }
 
@@ -156,8 +255,8 @@ public:
     }
 
     Residue<N> pow(unsigned p) const {
-        long long ans = 1;
-        long long now = value;
+        wide ans = 1;
+        wide now = value;
         while (p) {
             if (p % 2) {
                 ans *= now;
@@ -167,28 +266,34 @@ public:
             now *= now;
             now %= N;
         }
-        return Residue<N>(ans);
+        return Residue<N>(static_cast<long long>(ans));
     }
 
     Residue getInverse() const {
-        assert(is_prime_v<N>);
-        return pow(N - 2);
+        long long a = N, b = value;
+        long long x0 = 0, x1 = 1;
+        while (b) {
+            long long q = a / b;
+            long long t = a - q * b;
+            a = b;
+            b = t;
+            t = x0 - q * x1;
+            x0 = x1;
+            x1 = t;
+        }
+        assert(a == 1);
+        return Residue<N>(x0);
     }
 
     unsigned order() const {
         if (gcd(N, value) != 1) {
             return 0;
         }
-        unsigned funcEuler = functionEuler(N);
         unsigned ans = funcEuler;
-        for (unsigned i = 1; i * i <= funcEuler; i++) {
-            if (funcEuler % i == 0) {
-                if (pow(i).value == 1) {
-                    ans = std::min(ans, i);
-                }
-                if (pow(funcEuler / i).value == 1) {
-                    ans = std::min(ans, funcEuler / i);
-                }
+        for (unsigned i = 0; i < phiDivisors.count; i++) {
+            unsigned p = phiDivisors.primes[i];
+            while (ans % p == 0 && pow(ans / p).value == 1) {
+                ans /= p;
             }
         }
         return ans;
@@ -196,26 +301,7 @@ public:
 
     static Residue<N> getPrimitiveRoot() {
         assert(has_primitive_root_v<N>);
-        if (N == 2) {
-            return Residue<N>(1);
-        }
-        unsigned funcEuler = functionEuler(N);
-        std::vector <unsigned> pDivisors = primeDivisors(funcEuler);
-        unsigned ans = 0;
-        for (unsigned tmp = 2; tmp <= N; tmp++) {
-            bool flag = Residue<N>(tmp).pow(funcEuler).value == 1;
-            for (size_t i = 0; i < pDivisors.size(); ++i) {
-                if (Residue<N>(tmp).pow(funcEuler / pDivisors[i]).value == 1) {
-                    flag = false;
-                    break;
-                }
-            }
-            if (flag) {
-                ans = tmp;
-                break;
-            }
-        }
-        return Residue<N>(ans);
+        return Residue<N>(primitive_root_v<N>);
     }
 };
 
@@ -247,3 +333,900 @@ Residue<N> operator / (const Residue<N>& left, const Residue<N>& right) {
     return ans;
 } 
 
+
+
+template<unsigned N>
+struct montgomery {
+    static const bool enabled = N % 2 == 1 && N > (1u << 16) && N < (1u << 31);
+
+    static constexpr uint32_t inverseModR() {
+        uint32_t inv = N;
+        for (int i = 0; i < 5; i++) {
+            inv *= 2 - N * inv;
+        }
+        return inv;
+    }
+
+    static constexpr uint32_t nInv = inverseModR();
+    static constexpr uint32_t r = static_cast<uint32_t>((1ull << 32) % N);
+    static constexpr uint32_t r2 = static_cast<uint32_t>(static_cast<unsigned long long>(r) * r % N);
+
+    static uint32_t reduce(uint64_t x) {
+        uint32_t q = static_cast<uint32_t>(x) * nInv;
+        int64_t t = static_cast<int64_t>(x - static_cast<uint64_t>(q) * N) >> 32;
+        return static_cast<uint32_t>(t < 0 ? t + N : t);
+    }
+
+    static uint32_t toMontgomery(uint32_t x) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(x) << 32) % N);
+    }
+};
+
+template<unsigned N>
+class ResidueBatch {
+private:
+    using Value = Residue<N>;
+
+    static bool useAvx2() {
+#if defined(__AVX2__)
+        return true;
+#elif defined(RESIDUE_X86_DISPATCH)
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+#ifdef RESIDUE_X86_DISPATCH
+    static_assert(!montgomery<N>::enabled || sizeof(Value) == sizeof(uint32_t),
+                  "vector kernels need 32-bit residues");
+
+    __attribute__((target("avx2")))
+    static __m256i load(const Value* ptr) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    }
+
+    __attribute__((target("avx2")))
+    static void store(Value* ptr, __m256i x) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), x);
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i addMod(__m256i a, __m256i b, __m256i mod) {
+        __m256i sum = _mm256_add_epi32(a, b);
+        return _mm256_min_epu32(sum, _mm256_sub_epi32(sum, mod));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i subMod(__m256i a, __m256i b, __m256i mod) {
+        __m256i diff = _mm256_sub_epi32(a, b);
+        return _mm256_min_epu32(diff, _mm256_add_epi32(diff, mod));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i mulReduce(__m256i a, __m256i b, __m256i mod, __m256i nInv) {
+        __m256i prodEven = _mm256_mul_epu32(a, b);
+        __m256i prodOdd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i even = _mm256_sub_epi64(prodEven, _mm256_mul_epu32(_mm256_mul_epu32(prodEven, nInv), mod));
+        __m256i odd = _mm256_sub_epi64(prodOdd, _mm256_mul_epu32(_mm256_mul_epu32(prodOdd, nInv), mod));
+        __m256i res = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+        __m256i negative = _mm256_cmpgt_epi32(_mm256_setzero_si256(), res);
+        return _mm256_add_epi32(res, _mm256_and_si256(negative, mod));
+    }
+
+    __attribute__((target("avx2")))
+    static size_t addAvx2(Value* dst, const Value* a, const Value* b, size_t n) {
+        const __m256i mod = _mm256_set1_epi32(N);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            store(dst + i, addMod(load(a + i), load(b + i), mod));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static size_t subAvx2(Value* dst, const Value* a, const Value* b, size_t n) {
+        const __m256i mod = _mm256_set1_epi32(N);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            store(dst + i, subMod(load(a + i), load(b + i), mod));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static size_t mulAvx2(Value* dst, const Value* a, const Value* b, size_t n) {
+        const __m256i mod = _mm256_set1_epi32(N);
+        const __m256i nInv = _mm256_set1_epi32(montgomery<N>::nInv);
+        const __m256i r2 = _mm256_set1_epi32(montgomery<N>::r2);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i prod = mulReduce(load(a + i), load(b + i), mod, nInv);
+            store(dst + i, mulReduce(prod, r2, mod, nInv));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static size_t mulAddAvx2(Value* dst, const Value* a, Value c, size_t n) {
+        const __m256i mod = _mm256_set1_epi32(N);
+        const __m256i nInv = _mm256_set1_epi32(montgomery<N>::nInv);
+        const __m256i scalar = _mm256_set1_epi32(montgomery<N>::toMontgomery(c.value));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i prod = mulReduce(load(a + i), scalar, mod, nInv);
+            store(dst + i, addMod(load(dst + i), prod, mod));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static size_t dotAvx2(Value& res, const Value* a, const Value* b, size_t n) {
+        const __m256i mod = _mm256_set1_epi32(N);
+        const __m256i nInv = _mm256_set1_epi32(montgomery<N>::nInv);
+        __m256i acc = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            acc = addMod(acc, mulReduce(load(a + i), load(b + i), mod, nInv), mod);
+        }
+        Value lanes[8];
+        store(lanes, acc);
+        Value sum(0);
+        for (const Value& lane : lanes) {
+            sum += lane;
+        }
+        res.value = montgomery<N>::reduce(static_cast<uint64_t>(sum.value) * montgomery<N>::r2);
+        return i;
+    }
+#endif
+
+public:
+    static void add(Value* dst, const Value* a, const Value* b, size_t n) {
+        size_t i = 0;
+#ifdef RESIDUE_X86_DISPATCH
+        if constexpr (montgomery<N>::enabled) {
+            if (useAvx2()) {
+                i = addAvx2(dst, a, b, n);
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            dst[i] = a[i] + b[i];
+        }
+    }
+
+    static void sub(Value* dst, const Value* a, const Value* b, size_t n) {
+        size_t i = 0;
+#ifdef RESIDUE_X86_DISPATCH
+        if constexpr (montgomery<N>::enabled) {
+            if (useAvx2()) {
+                i = subAvx2(dst, a, b, n);
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            dst[i] = a[i] - b[i];
+        }
+    }
+
+    static void mul(Value* dst, const Value* a, const Value* b, size_t n) {
+        size_t i = 0;
+#ifdef RESIDUE_X86_DISPATCH
+        if constexpr (montgomery<N>::enabled) {
+            if (useAvx2()) {
+                i = mulAvx2(dst, a, b, n);
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            dst[i] = a[i] * b[i];
+        }
+    }
+
+    static void mulAdd(Value* dst, const Value* a, Value c, size_t n) {
+        size_t i = 0;
+#ifdef RESIDUE_X86_DISPATCH
+        if constexpr (montgomery<N>::enabled) {
+            if (useAvx2()) {
+                i = mulAddAvx2(dst, a, c, n);
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            dst[i] += a[i] * c;
+        }
+    }
+
+    static Value dot(const Value* a, const Value* b, size_t n) {
+        Value res(0);
+        size_t i = 0;
+#ifdef RESIDUE_X86_DISPATCH
+        if constexpr (montgomery<N>::enabled) {
+            if (useAvx2()) {
+                i = dotAvx2(res, a, b, n);
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            res += a[i] * b[i];
+        }
+        return res;
+    }
+
+    static void prefixProducts(Value* dst, const Value* a, size_t n) {
+        Value now(1);
+        for (size_t i = 0; i < n; i++) {
+            now *= a[i];
+            dst[i] = now;
+        }
+    }
+
+    static void inverse(Value* dst, const Value* a, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        std::vector<Value> prefix(n);
+        prefixProducts(prefix.data(), a, n);
+        Value inv = prefix[n - 1].getInverse();
+        for (size_t i = n - 1; i > 0; i--) {
+            Value ai = a[i];
+            dst[i] = inv * prefix[i - 1];
+            inv *= ai;
+        }
+        dst[0] = inv;
+    }
+
+    static void div(Value* dst, const Value* a, const Value* b, size_t n) {
+        std::vector<Value> inv(n);
+        inverse(inv.data(), b, n);
+        mul(dst, a, inv.data(), n);
+    }
+};
+
+
+template<typename Integer = unsigned long long>
+class ResidueContext {
+private:
+    Integer mod;
+
+public:
+    explicit ResidueContext(const Integer& modulus) : mod(modulus) {
+        assert(Integer(0) < mod);
+    }
+
+    const Integer& modulus() const {
+        return mod;
+    }
+
+    Integer reduce(const Integer& x) const {
+        Integer res = x % mod;
+        if constexpr (!std::is_unsigned_v<Integer>) {
+            if (res < Integer(0)) {
+                res += mod;
+            }
+        }
+        return res;
+    }
+
+    Integer toForm(const Integer& x) const {
+        return reduce(x);
+    }
+
+    Integer fromForm(const Integer& x) const {
+        return x;
+    }
+
+    Integer one() const {
+        return reduce(Integer(1));
+    }
+
+    Integer add(const Integer& a, const Integer& b) const {
+        Integer gap = mod - b;
+        return a < gap ? a + b : a - gap;
+    }
+
+    Integer sub(const Integer& a, const Integer& b) const {
+        return a < b ? a + (mod - b) : a - b;
+    }
+
+    Integer mul(const Integer& a, const Integer& b) const {
+        if constexpr (std::is_integral_v<Integer>) {
+            using Wide = std::conditional_t<(sizeof(Integer) < sizeof(unsigned long long)),
+                                            unsigned long long, unsigned __int128>;
+            return static_cast<Integer>(static_cast<Wide>(a) * static_cast<Wide>(b) % static_cast<Wide>(mod));
+        } else {
+            return reduce(a * b);
+        }
+    }
+
+    Integer inverse(const Integer& x) const {
+        if constexpr (std::is_integral_v<Integer>) {
+            __int128 a = mod, b = x;
+            __int128 x0 = 0, x1 = 1;
+            while (b != 0) {
+                __int128 q = a / b;
+                __int128 t = a - q * b;
+                a = b;
+                b = t;
+                t = x0 - q * x1;
+                x0 = x1;
+                x1 = t;
+            }
+            assert(a == 1);
+            if (x0 < 0) {
+                x0 += mod;
+            }
+            return static_cast<Integer>(x0);
+        } else {
+            Integer a = mod, b = x;
+            Integer x0 = Integer(0), x1 = Integer(1);
+            while (b != Integer(0)) {
+                Integer q = a / b;
+                Integer r = a - q * b;
+                a = b;
+                b = r;
+                Integer t = x0 - q * x1;
+                x0 = x1;
+                x1 = t;
+            }
+            assert(a == Integer(1));
+            return reduce(x0);
+        }
+    }
+};
+
+template<>
+class ResidueContext<unsigned long long> {
+private:
+    using u64 = unsigned long long;
+    using u128 = unsigned __int128;
+
+    u64 mod;
+    u64 nInv = 0;
+    u64 r = 0;
+    u64 r2 = 0;
+    bool montgomery;
+
+    u64 redc(u128 x) const {
+        u64 q = static_cast<u64>(x) * nInv;
+        u64 hi = static_cast<u64>(x >> 64);
+        u64 sub = static_cast<u64>((static_cast<u128>(q) * mod) >> 64);
+        return hi >= sub ? hi - sub : hi - sub + mod;
+    }
+
+public:
+    explicit ResidueContext(u64 modulus) : mod(modulus), montgomery(modulus % 2 == 1 && modulus > 1) {
+        assert(mod > 0);
+        if (montgomery) {
+            nInv = mod;
+            for (int i = 0; i < 6; i++) {
+                nInv *= 2 - mod * nInv;
+            }
+            r = static_cast<u64>((static_cast<u128>(1) << 64) % mod);
+            r2 = static_cast<u64>(static_cast<u128>(r) * r % mod);
+        }
+    }
+
+    u64 modulus() const {
+        return mod;
+    }
+
+    u64 reduce(u64 x) const {
+        return x % mod;
+    }
+
+    u64 toForm(u64 x) const {
+        return montgomery ? redc(static_cast<u128>(x % mod) * r2) : x % mod;
+    }
+
+    u64 fromForm(u64 x) const {
+        return montgomery ? redc(x) : x;
+    }
+
+    u64 one() const {
+        return montgomery ? r : 1 % mod;
+    }
+
+    u64 add(u64 a, u64 b) const {
+        u64 res = a + b;
+        return (res < a || res >= mod) ? res - mod : res;
+    }
+
+    u64 sub(u64 a, u64 b) const {
+        return a >= b ? a - b : a - b + mod;
+    }
+
+    u64 mul(u64 a, u64 b) const {
+        if (montgomery) {
+            return redc(static_cast<u128>(a) * b);
+        }
+        return static_cast<u64>(static_cast<u128>(a) * b % mod);
+    }
+
+    u64 inverse(u64 x) const {
+        __int128 a = mod, b = fromForm(x);
+        __int128 x0 = 0, x1 = 1;
+        while (b != 0) {
+            __int128 q = a / b;
+            __int128 t = a - q * b;
+            a = b;
+            b = t;
+            t = x0 - q * x1;
+            x0 = x1;
+            x1 = t;
+        }
+        assert(a == 1);
+        if (x0 < 0) {
+            x0 += mod;
+        }
+        return toForm(static_cast<u64>(x0));
+    }
+};
+
+template<typename Integer = unsigned long long>
+class DynResidue {
+public:
+    using Context = std::shared_ptr<const ResidueContext<Integer>>;
+
+    static Context makeContext(const Integer& modulus) {
+        return std::make_shared<const ResidueContext<Integer>>(modulus);
+    }
+
+private:
+    const ResidueContext<Integer>* context;
+    Integer value;
+
+    DynResidue(const ResidueContext<Integer>* context, const Integer& value, bool) : context(context), value(value) {}
+
+public:
+    DynResidue(const ResidueContext<Integer>& context, const Integer& val)
+            : context(&context), value(context.toForm(val)) {}
+
+    DynResidue(const Context& context, const Integer& val) : DynResidue(*context, val) {}
+
+    const ResidueContext<Integer>& getContext() const {
+        return *context;
+    }
+
+    explicit operator Integer() const {
+        return context->fromForm(value);
+    }
+
+    bool operator == (const DynResidue& other) const {
+        return value == other.value;
+    }
+
+    bool operator != (const DynResidue& other) const {
+        return !(value == other.value);
+    }
+
+    DynResidue& operator += (const DynResidue& right) {
+        value = context->add(value, right.value);
+        return *this;
+    }
+
+    DynResidue& operator -= (const DynResidue& right) {
+        value = context->sub(value, right.value);
+        return *this;
+    }
+
+    DynResidue& operator *= (const DynResidue& right) {
+        value = context->mul(value, right.value);
+        return *this;
+    }
+
+    DynResidue& operator /= (const DynResidue& right) {
+        *this *= right.getInverse();
+        return *this;
+    }
+
+    DynResidue pow(unsigned long long p) const {
+        Integer ans = context->one();
+        Integer now = value;
+        while (p) {
+            if (p % 2) {
+                ans = context->mul(ans, now);
+            }
+            p /= 2;
+            now = context->mul(now, now);
+        }
+        return DynResidue(context, ans, true);
+    }
+
+    DynResidue getInverse() const {
+        return DynResidue(context, context->inverse(value), true);
+    }
+};
+
+template<typename Integer>
+DynResidue<Integer> operator + (const DynResidue<Integer>& left, const DynResidue<Integer>& right) {
+    DynResidue<Integer> ans = left;
+    ans += right;
+    return ans;
+}
+
+template<typename Integer>
+DynResidue<Integer> operator - (const DynResidue<Integer>& left, const DynResidue<Integer>& right) {
+    DynResidue<Integer> ans = left;
+    ans -= right;
+    return ans;
+}
+
+template<typename Integer>
+DynResidue<Integer> operator * (const DynResidue<Integer>& left, const DynResidue<Integer>& right) {
+    DynResidue<Integer> ans = left;
+    ans *= right;
+    return ans;
+}
+
+template<typename Integer>
+DynResidue<Integer> operator / (const DynResidue<Integer>& left, const DynResidue<Integer>& right) {
+    DynResidue<Integer> ans = left;
+    ans /= right;
+    return ans;
+}
+
+
+template<typename T>
+class GrowingTable {
+private:
+    static const size_t FIRST_LOG = 6;
+    static const size_t MAX_BLOCKS = 64 - FIRST_LOG;
+
+    T* blocks[MAX_BLOCKS] = {};
+    size_t blockCount = 0;
+    std::atomic<size_t> ready{0};
+    std::mutex growMutex;
+
+    static size_t blockIndex(size_t i) {
+        return 63 - __builtin_clzll(i + (size_t(1) << FIRST_LOG)) - FIRST_LOG;
+    }
+
+    static size_t blockStart(size_t k) {
+        return ((size_t(1) << FIRST_LOG) << k) - (size_t(1) << FIRST_LOG);
+    }
+
+    T& at(size_t i) {
+        size_t k = blockIndex(i);
+        return blocks[k][i - blockStart(k)];
+    }
+
+public:
+    GrowingTable() = default;
+    GrowingTable(const GrowingTable&) = delete;
+    GrowingTable& operator = (const GrowingTable&) = delete;
+
+    ~GrowingTable() {
+        for (size_t k = 0; k < blockCount; k++) {
+            delete[] blocks[k];
+        }
+    }
+
+    size_t size() const {
+        return ready.load(std::memory_order_acquire);
+    }
+
+    const T& operator[](size_t i) const {
+        size_t k = blockIndex(i);
+        return blocks[k][i - blockStart(k)];
+    }
+
+    template<typename Fill>
+    void grow(size_t n, size_t limit, Fill fill) {
+        std::lock_guard<std::mutex> lock(growMutex);
+        size_t old = ready.load(std::memory_order_relaxed);
+        if (n <= old) {
+            return;
+        }
+        size_t target = std::min(std::max(n, 2 * old), limit);
+        while (blockStart(blockCount) < target) {
+            blocks[blockCount] = new T[(size_t(1) << FIRST_LOG) << blockCount];
+            blockCount++;
+        }
+        fill([this](size_t i) -> T& { return at(i); }, old, target);
+        ready.store(target, std::memory_order_release);
+    }
+};
+
+template<unsigned N>
+class ResidueTables {
+private:
+    using Value = Residue<N>;
+
+    struct Entry {
+        Value fact;
+        Value invFact;
+        Value inv;
+    };
+
+    GrowingTable<Entry> table;
+
+    ResidueTables() = default;
+
+    const Entry& entry(size_t n) {
+        if (n >= table.size()) {
+            assert(n < minimalDivisor<N>::value);
+            table.grow(n + 1, minimalDivisor<N>::value, [](auto at, size_t from, size_t to) {
+                for (size_t i = from; i < to; i++) {
+                    at(i).fact = i == 0 ? Value(1) : at(i - 1).fact * Value(static_cast<long long>(i));
+                }
+                Value inv = at(to - 1).fact.getInverse();
+                for (size_t i = to; i-- > from;) {
+                    at(i).invFact = inv;
+                    at(i).inv = i == 0 ? Value(0) : inv * at(i - 1).fact;
+                    inv *= Value(static_cast<long long>(i));
+                }
+            });
+        }
+        return table[n];
+    }
+
+public:
+    static ResidueTables& getTables() {
+        static ResidueTables instance;
+        return instance;
+    }
+
+    void reserve(size_t n) {
+        if (n > 0) {
+            entry(n - 1);
+        }
+    }
+
+    Value factorial(size_t n) {
+        return entry(n).fact;
+    }
+
+    Value inverseFactorial(size_t n) {
+        return entry(n).invFact;
+    }
+
+    Value inverse(size_t n) {
+        assert(n > 0);
+        return entry(n).inv;
+    }
+
+    Value binomial(size_t n, size_t k) {
+        if (k > n) {
+            return Value(0);
+        }
+        return entry(n).fact * entry(k).invFact * entry(n - k).invFact;
+    }
+};
+
+template<unsigned N>
+class ResiduePowers {
+private:
+    using Value = Residue<N>;
+
+    static const unsigned WINDOW = 8;
+    static const unsigned WINDOWS = 32 / WINDOW;
+
+    Value base;
+    Value windows[WINDOWS][1 << WINDOW];
+    GrowingTable<Value> powers;
+
+public:
+    explicit ResiduePowers(Value base) : base(base) {
+        Value step = base;
+        for (unsigned w = 0; w < WINDOWS; w++) {
+            windows[w][0] = Value(1);
+            for (unsigned d = 1; d < (1u << WINDOW); d++) {
+                windows[w][d] = windows[w][d - 1] * step;
+            }
+            step = windows[w][(1 << WINDOW) - 1] * step;
+        }
+    }
+
+    Value pow(unsigned p) const {
+        Value res = windows[0][p & ((1 << WINDOW) - 1)];
+        for (unsigned w = 1; w < WINDOWS; w++) {
+            p >>= WINDOW;
+            res *= windows[w][p & ((1 << WINDOW) - 1)];
+        }
+        return res;
+    }
+
+    Value operator[](size_t i) {
+        if (i >= powers.size()) {
+            Value b = base;
+            powers.grow(i + 1, SIZE_MAX, [b](auto at, size_t from, size_t to) {
+                for (size_t j = from; j < to; j++) {
+                    at(j) = j == 0 ? Value(1) : at(j - 1) * b;
+                }
+            });
+        }
+        return powers[i];
+    }
+};
+
+
+template<unsigned N>
+class DiscreteLog {
+private:
+    using Value = Residue<N>;
+
+    struct Subgroup {
+        unsigned prime;
+        unsigned power;
+        unsigned exponent;
+        unsigned babySteps;
+        Value gamma;
+        Value generatorInverse;
+        Value giantStep;
+        std::vector<unsigned> keys;
+        std::vector<unsigned> steps;
+    };
+
+    static constexpr unsigned EMPTY = ~0u;
+
+    Value base;
+    unsigned ord;
+    std::vector<Subgroup> subgroups;
+
+    static unsigned key(Value x) {
+        return static_cast<unsigned>(static_cast<int>(x));
+    }
+
+    static size_t slot(unsigned k, size_t mask) {
+        return (k * 0x9E3779B97F4A7C15ull >> 20) & mask;
+    }
+
+    static void buildTable(Subgroup& sub, unsigned long long queries) {
+        unsigned long long m = 1;
+        while (m * m < sub.prime * queries && m < sub.prime) {
+            m++;
+        }
+        sub.babySteps = static_cast<unsigned>(m);
+        size_t capacity = 1;
+        while (capacity < 2 * m) {
+            capacity *= 2;
+        }
+        sub.keys.assign(capacity, EMPTY);
+        sub.steps.assign(capacity, 0);
+        Value now(1);
+        for (unsigned j = 0; j < m; j++) {
+            size_t i = slot(key(now), capacity - 1);
+            while (sub.keys[i] != EMPTY && sub.keys[i] != key(now)) {
+                i = (i + 1) & (capacity - 1);
+            }
+            if (sub.keys[i] == EMPTY) {
+                sub.keys[i] = key(now);
+                sub.steps[i] = j;
+            }
+            now *= sub.gamma;
+        }
+        sub.giantStep = now.getInverse();
+    }
+
+    static std::optional<unsigned> babyGiant(const Subgroup& sub, Value h) {
+        size_t mask = sub.keys.size() - 1;
+        unsigned giants = (sub.prime + sub.babySteps - 1) / sub.babySteps;
+        for (unsigned i = 0; i <= giants; i++) {
+            for (size_t j = slot(key(h), mask); sub.keys[j] != EMPTY; j = (j + 1) & mask) {
+                if (sub.keys[j] == key(h)) {
+                    return static_cast<unsigned>((static_cast<unsigned long long>(i) * sub.babySteps +
+                                                  sub.steps[j]) % sub.prime);
+                }
+            }
+            h *= sub.giantStep;
+        }
+        return std::nullopt;
+    }
+
+public:
+    explicit DiscreteLog(Value base, unsigned long long expectedQueries = 1) : base(base), ord(base.order()) {
+        assert(ord != 0);
+        primeDivisorList divisors = primeDivisors(ord);
+        for (unsigned i = 0; i < divisors.count; i++) {
+            Subgroup sub;
+            sub.prime = divisors.primes[i];
+            sub.power = 1;
+            sub.exponent = 0;
+            while (ord / sub.power % sub.prime == 0) {
+                sub.power *= sub.prime;
+                sub.exponent++;
+            }
+            sub.gamma = base.pow(ord / sub.prime);
+            sub.generatorInverse = base.pow(ord / sub.power).getInverse();
+            buildTable(sub, expectedQueries);
+            subgroups.push_back(std::move(sub));
+        }
+    }
+
+    unsigned order() const {
+        return ord;
+    }
+
+    std::optional<unsigned> log(Value h) const {
+        if (h.order() == 0) {
+            return std::nullopt;
+        }
+        unsigned long long ans = 0;
+        unsigned long long modulus = 1;
+        for (const Subgroup& sub : subgroups) {
+            Value hq = h.pow(ord / sub.power);
+            unsigned long long x = 0;
+            unsigned long long qk = 1;
+            for (unsigned k = 0; k < sub.exponent; k++) {
+                Value hk = (sub.generatorInverse.pow(static_cast<unsigned>(x)) * hq).pow(sub.power / sub.prime / static_cast<unsigned>(qk));
+                std::optional<unsigned> digit = babyGiant(sub, hk);
+                if (!digit) {
+                    return std::nullopt;
+                }
+                x += *digit * qk;
+                qk *= sub.prime;
+            }
+            unsigned long long step = (x + sub.power - ans % sub.power) % sub.power;
+            ans += modulus * (step * inverseMod(modulus % sub.power, sub.power) % sub.power);
+            modulus *= sub.power;
+        }
+        if (base.pow(static_cast<unsigned>(ans)) != h) {
+            return std::nullopt;
+        }
+        return static_cast<unsigned>(ans);
+    }
+};
+
+template<unsigned N>
+class SquareRoot {
+private:
+    using Value = Residue<N>;
+
+    static_assert(is_prime_v<N>, "square roots are only supported for a prime modulus");
+
+    static constexpr unsigned twoAdicity() {
+        unsigned s = 0;
+        unsigned q = N - 1;
+        while (q != 0 && q % 2 == 0) {
+            q /= 2;
+            s++;
+        }
+        return s;
+    }
+
+    static constexpr unsigned nonResidue() {
+        for (unsigned z = 2; z < N; z++) {
+            if (powMod(z, (N - 1) / 2, N) == N - 1) {
+                return z;
+            }
+        }
+        return 1;
+    }
+
+    static constexpr unsigned S = twoAdicity();
+    static constexpr unsigned Q = (N - 1) >> S;
+    static constexpr unsigned C = static_cast<unsigned>(powMod(nonResidue(), Q, N));
+
+public:
+    static std::optional<Value> find(Value a) {
+        if (N == 2 || a == Value(0)) {
+            return a;
+        }
+        if (a.pow((N - 1) / 2) != Value(1)) {
+            return std::nullopt;
+        }
+        unsigned m = S;
+        Value c(C);
+        Value t = a.pow(Q);
+        Value r = a.pow((Q + 1) / 2);
+        while (t != Value(1)) {
+            unsigned i = 0;
+            Value t2 = t;
+            while (t2 != Value(1)) {
+                t2 *= t2;
+                i++;
+            }
+            Value b = c;
+            for (unsigned j = 0; j + i + 1 < m; j++) {
+                b *= b;
+            }
+            m = i;
+            c = b * b;
+            t *= c;
+            r *= b;
+        }
+        return r;
+    }
+};
@@ -0,0 +1,316 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "string.h"
+
+class Rope {
+private:
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+    struct Node {
+        std::shared_ptr<const String> buffer;
+        size_t offset;
+        size_t length;
+        size_t total;
+        unsigned priority;
+        Node* left = nullptr;
+        Node* right = nullptr;
+
+        Node(std::shared_ptr<const String> buffer, size_t offset, size_t length)
+                : buffer(std::move(buffer)), offset(offset), length(length), total(length),
+                  priority(randomPriority()) {}
+
+        StringView chunk() const {
+            return StringView(buffer->data() + offset, length);
+        }
+    };
+
+    Node* root = nullptr;
+
+    static unsigned randomPriority() {
+        static thread_local unsigned state = 2463534242u;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    static size_t total(const Node* t) {
+        return t == nullptr ? 0 : t->total;
+    }
+
+    static void update(Node* t) {
+        t->total = t->length + total(t->left) + total(t->right);
+    }
+
+    static Node* merge(Node* a, Node* b) {
+        if (a == nullptr) {
+            return b;
+        }
+        if (b == nullptr) {
+            return a;
+        }
+        if (a->priority > b->priority) {
+            a->right = merge(a->right, b);
+            update(a);
+            return a;
+        }
+        b->left = merge(a, b->left);
+        update(b);
+        return b;
+    }
+
+    static void split(Node* t, size_t pos, Node*& l, Node*& r) {
+        if (t == nullptr) {
+            l = r = nullptr;
+            return;
+        }
+        size_t leftTotal = total(t->left);
+        if (pos <= leftTotal) {
+            split(t->left, pos, l, t->left);
+            update(t);
+            r = t;
+        } else if (pos >= leftTotal + t->length) {
+            split(t->right, pos - leftTotal - t->length, t->right, r);
+            update(t);
+            l = t;
+        } else {
+            size_t k = pos - leftTotal;
+            Node* tail = new Node(t->buffer, t->offset + k, t->length - k);
+            t->length = k;
+            r = merge(tail, t->right);
+            t->right = nullptr;
+            update(t);
+            l = t;
+        }
+    }
+
+    static Node* build(StringView text) {
+        if (text.empty()) {
+            return nullptr;
+        }
+        auto buffer = std::make_shared<const String>(text);
+        Node* res = nullptr;
+        for (size_t start = 0; start < text.length(); start += CHUNK_SIZE) {
+            size_t count = std::min(CHUNK_SIZE, text.length() - start);
+            res = merge(res, new Node(buffer, start, count));
+        }
+        return res;
+    }
+
+    static Node* copy(const Node* t) {
+        if (t == nullptr) {
+            return nullptr;
+        }
+        Node* res = new Node(*t);
+        res->left = copy(t->left);
+        res->right = copy(t->right);
+        return res;
+    }
+
+    static void destroy(Node* t) {
+        if (t == nullptr) {
+            return;
+        }
+        destroy(t->left);
+        destroy(t->right);
+        delete t;
+    }
+
+    template<typename F>
+    static void visit(const Node* t, F& f) {
+        if (t == nullptr) {
+            return;
+        }
+        visit(t->left, f);
+        f(t->chunk());
+        visit(t->right, f);
+    }
+
+public:
+    class iterator {
+    private:
+        std::vector<const Node*> stack;
+        const Node* node = nullptr;
+        size_t index = 0;
+
+        void descend(const Node* t) {
+            while (t != nullptr) {
+                stack.push_back(t);
+                t = t->left;
+            }
+        }
+
+        void nextNode() {
+            if (stack.empty()) {
+                node = nullptr;
+                return;
+            }
+            node = stack.back();
+            stack.pop_back();
+            descend(node->right);
+            index = 0;
+            if (node->length == 0) {
+                nextNode();
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char;
+        using reference = const char&;
+        using pointer = const char*;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        explicit iterator(const Node* root) {
+            descend(root);
+            nextNode();
+        }
+
+        const char& operator*() const {
+            return node->chunk()[index];
+        }
+
+        iterator& operator++() {
+            if (++index == node->length) {
+                nextNode();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator res = *this;
+            ++(*this);
+            return res;
+        }
+
+        bool operator == (const iterator& other) const {
+            return node == other.node && (node == nullptr || index == other.index);
+        }
+
+        bool operator != (const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    Rope() {}
+
+    Rope(StringView text) : root(build(text)) {}
+
+    Rope(const Rope& other) : root(copy(other.root)) {}
+
+    Rope(Rope&& other) : root(other.root) {
+        other.root = nullptr;
+    }
+
+    Rope& operator = (Rope other) {
+        std::swap(root, other.root);
+        return *this;
+    }
+
+    ~Rope() {
+        destroy(root);
+    }
+
+    size_t length() const {
+        return total(root);
+    }
+
+    bool empty() const {
+        return root == nullptr;
+    }
+
+    char operator[](size_t pos) const {
+        const Node* t = root;
+        while (true) {
+            size_t leftTotal = total(t->left);
+            if (pos < leftTotal) {
+                t = t->left;
+            } else if (pos < leftTotal + t->length) {
+                return t->chunk()[pos - leftTotal];
+            } else {
+                pos -= leftTotal + t->length;
+                t = t->right;
+            }
+        }
+    }
+
+    void insert(size_t pos, StringView text) {
+        Node* l;
+        Node* r;
+        split(root, pos, l, r);
+        root = merge(merge(l, build(text)), r);
+    }
+
+    void erase(size_t pos, size_t count) {
+        Node* l;
+        Node* mid;
+        Node* r;
+        split(root, pos, l, r);
+        split(r, count, mid, r);
+        destroy(mid);
+        root = merge(l, r);
+    }
+
+    void append(StringView text) {
+        root = merge(root, build(text));
+    }
+
+    Rope& operator += (Rope&& other) {
+        root = merge(root, other.root);
+        other.root = nullptr;
+        return *this;
+    }
+
+    Rope& operator += (const Rope& other) {
+        return *this += Rope(other);
+    }
+
+    Rope substr(size_t start, size_t count) const {
+        Rope res(*this);
+        res.erase(start + count, res.length() - std::min(res.length(), start + count));
+        res.erase(0, start);
+        return res;
+    }
+
+    template<typename F>
+    void forEachChunk(F f) const {
+        visit(root, f);
+    }
+
+    String toString() const {
+        String res;
+        res.reserve(length());
+        forEachChunk([&res](StringView chunk) { res.append(chunk); });
+        return res;
+    }
+
+    void compact() {
+        *this = Rope(toString());
+    }
+
+    iterator begin() const {
+        return iterator(root);
+    }
+
+    iterator end() const {
+        return iterator();
+    }
+};
+
+Rope operator + (Rope left, Rope&& right) {
+    left += std::move(right);
+    return left;
+}
+
+Rope operator + (Rope left, const Rope& right) {
+    left += right;
+    return left;
+}
+
+std::ostream& operator << (std::ostream& out, const Rope& rope) {
+    rope.forEachChunk([&out](StringView chunk) { out << chunk; });
+    return out;
+}
@@ -1,35 +1,726 @@
+#pragma once
 #include <iostream>
+#include <fstream>
 #include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <iterator>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
-class String {
+#if defined(__unix__) || defined(__APPLE__)
+#define STRING_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STRING_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+class StringKernels {
 private:
-    size_t len = 0, capacity = 0;
-    char* str = nullptr;
-    
-    void swap(String& other) {
-        std::swap(len, other.len);
-        std::swap(capacity, other.capacity);
-        std::swap(str, other.str);
+    static unsigned char lower(unsigned char c) {
+        return static_cast<unsigned>(c - 'A') < 26u ? c + ('a' - 'A') : c;
     }
 
-    void reserve(size_t newcap) {
-        if (newcap <= capacity) {
-            return;
+    static bool useAvx2() {
+#if defined(__AVX2__)
+        return true;
+#elif defined(STRING_X86_DISPATCH)
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    static size_t countScalar(const unsigned char* a, size_t n, unsigned char c) {
+        size_t res = 0;
+        for (size_t i = 0; i < n; i++) {
+            res += a[i] == c;
         }
-        char* newstr = new char[newcap];
-        memcpy(newstr, str, len);
-        delete[] str;
-        str = newstr;
-        capacity = newcap;
+        return res;
     }
 
-    bool isSubstring(size_t start, const String& substr) const {
-        for (size_t i = 0; i < substr.length(); ++i) {
-            if (str[i + start] != substr[i]) {
-                return false;
+    static int compareIgnoreCaseScalar(const unsigned char* a, const unsigned char* b, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (lower(a[i]) != lower(b[i])) {
+                return lower(a[i]) < lower(b[i]) ? -1 : 1;
             }
         }
-        return true;
+        return 0;
+    }
+
+#ifdef STRING_X86_DISPATCH
+    __attribute__((target("avx2")))
+    static size_t countAvx2(const unsigned char* a, size_t n, unsigned char c) {
+        const __m256i needle = _mm256_set1_epi8(static_cast<char>(c));
+        size_t res = 0;
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, needle)));
+            res += __builtin_popcount(mask);
+        }
+        return res + countScalar(a + i, n - i, c);
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i lowerAvx2(__m256i x) {
+        __m256i shifted = _mm256_sub_epi8(x, _mm256_set1_epi8('A'));
+        __m256i upper = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(25)), shifted);
+        return _mm256_or_si256(x, _mm256_and_si256(upper, _mm256_set1_epi8('a' - 'A')));
+    }
+
+    __attribute__((target("avx2")))
+    static int compareIgnoreCaseAvx2(const unsigned char* a, const unsigned char* b, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = lowerAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+            __m256i y = lowerAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+            if (mask != ~0u) {
+                size_t j = i + __builtin_ctz(~mask);
+                return lower(a[j]) < lower(b[j]) ? -1 : 1;
+            }
+        }
+        return compareIgnoreCaseScalar(a + i, b + i, n - i);
+    }
+#endif
+
+    static uint64_t read8(const unsigned char* p) {
+        uint64_t res;
+        memcpy(&res, p, 8);
+        return res;
+    }
+
+    static uint64_t read4(const unsigned char* p) {
+        uint32_t res;
+        memcpy(&res, p, 4);
+        return res;
+    }
+
+    static uint64_t mix(uint64_t a, uint64_t b) {
+        unsigned __int128 res = static_cast<unsigned __int128>(a) * b;
+        return static_cast<uint64_t>(res) ^ static_cast<uint64_t>(res >> 64);
+    }
+
+public:
+    static uint64_t hash(const char* data, size_t n, uint64_t seed = 0) {
+        static const uint64_t s0 = 0xa0761d6478bd642full;
+        static const uint64_t s1 = 0xe7037ed1a0b428dbull;
+        static const uint64_t s2 = 0x8ebc6af09c88c6e3ull;
+        static const uint64_t s3 = 0x589965cc75374cc3ull;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        seed ^= mix(seed ^ s0, s1);
+        uint64_t a, b;
+        if (n <= 16) {
+            if (n >= 4) {
+                size_t shift = (n >> 3) << 2;
+                a = (read4(p) << 32) | read4(p + shift);
+                b = (read4(p + n - 4) << 32) | read4(p + n - 4 - shift);
+            } else if (n > 0) {
+                a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[n >> 1]) << 8) | p[n - 1];
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            size_t i = n;
+            if (i > 48) {
+                uint64_t lane1 = seed, lane2 = seed;
+                do {
+                    seed = mix(read8(p) ^ s1, read8(p + 8) ^ seed);
+                    lane1 = mix(read8(p + 16) ^ s2, read8(p + 24) ^ lane1);
+                    lane2 = mix(read8(p + 32) ^ s3, read8(p + 40) ^ lane2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= lane1 ^ lane2;
+            }
+            while (i > 16) {
+                seed = mix(read8(p) ^ s1, read8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = read8(p + i - 16);
+            b = read8(p + i - 8);
+        }
+        a ^= s1;
+        b ^= seed;
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        a = static_cast<uint64_t>(product);
+        b = static_cast<uint64_t>(product >> 64);
+        return mix(a ^ s0 ^ n, b ^ s1);
+    }
+
+    static bool equal(const char* a, const char* b, size_t n) {
+        return memcmp(a, b, n) == 0;
+    }
+
+    static int compare(const char* a, size_t n, const char* b, size_t m) {
+        int res = memcmp(a, b, std::min(n, m));
+        if (res != 0) {
+            return res < 0 ? -1 : 1;
+        }
+        return n < m ? -1 : (n > m ? 1 : 0);
+    }
+
+    static size_t findByte(const char* a, size_t n, char c) {
+        if (n == 0) {
+            return 0;
+        }
+        const void* res = memchr(a, c, n);
+        return res == nullptr ? n : static_cast<const char*>(res) - a;
+    }
+
+    static size_t countByte(const char* a, size_t n, char c) {
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(a);
+#ifdef STRING_X86_DISPATCH
+        if (useAvx2()) {
+            return countAvx2(data, n, static_cast<unsigned char>(c));
+        }
+#endif
+        return countScalar(data, n, static_cast<unsigned char>(c));
+    }
+
+    static int compareIgnoreCase(const char* a, size_t n, const char* b, size_t m) {
+        const unsigned char* x = reinterpret_cast<const unsigned char*>(a);
+        const unsigned char* y = reinterpret_cast<const unsigned char*>(b);
+#ifdef STRING_X86_DISPATCH
+        int res = useAvx2() ? compareIgnoreCaseAvx2(x, y, std::min(n, m))
+                            : compareIgnoreCaseScalar(x, y, std::min(n, m));
+#else
+        int res = compareIgnoreCaseScalar(x, y, std::min(n, m));
+#endif
+        if (res != 0) {
+            return res;
+        }
+        return n < m ? -1 : (n > m ? 1 : 0);
+    }
+};
+
+template<bool reverse>
+class BasicSearcher {
+private:
+    enum class Kind { EMPTY, BYTE_SCAN, TWO_WAY, HORSPOOL };
+
+    static const size_t SHORT_NEEDLE = 8;
+    static const size_t LONG_NEEDLE = 32;
+    static const size_t RICH_ALPHABET = 8;
+
+    struct Text {
+        const unsigned char* data;
+        size_t n;
+
+        unsigned char operator[](size_t i) const {
+            return reverse ? data[n - 1 - i] : data[i];
+        }
+    };
+
+    std::vector<unsigned char> needle;
+    Kind kind = Kind::EMPTY;
+    ptrdiff_t ell = -1;
+    size_t period = 1;
+    bool periodic = false;
+    size_t shift[256];
+
+    static ptrdiff_t maximalSuffix(const unsigned char* x, size_t m, size_t& p, bool tilde) {
+        ptrdiff_t ms = -1;
+        size_t j = 0, k = 1;
+        p = 1;
+        while (j + k < m) {
+            unsigned char a = x[j + k];
+            unsigned char b = x[ms + k];
+            if (tilde ? a > b : a < b) {
+                j += k;
+                k = 1;
+                p = j - ms;
+            } else if (a == b) {
+                if (k != p) {
+                    ++k;
+                } else {
+                    j += p;
+                    k = 1;
+                }
+            } else {
+                ms = j;
+                j = ms + 1;
+                k = p = 1;
+            }
+        }
+        return ms;
+    }
+
+    void prepareTwoWay() {
+        size_t m = needle.size();
+        size_t p, q;
+        ptrdiff_t i = maximalSuffix(needle.data(), m, p, false);
+        ptrdiff_t j = maximalSuffix(needle.data(), m, q, true);
+        ell = i > j ? i : j;
+        period = i > j ? p : q;
+        periodic = period + ell + 1 <= m && memcmp(needle.data(), needle.data() + period, ell + 1) == 0;
+        if (!periodic) {
+            period = std::max(static_cast<size_t>(ell + 1), m - ell - 1) + 1;
+        }
+    }
+
+    void prepareHorspool() {
+        size_t m = needle.size();
+        for (size_t& s : shift) {
+            s = m;
+        }
+        for (size_t i = 0; i + 1 < m; i++) {
+            shift[needle[i]] = m - 1 - i;
+        }
+    }
+
+    size_t byteScan(const Text& y) const {
+        size_t m = needle.size();
+        const unsigned char* x = needle.data();
+        if (!reverse) {
+            const unsigned char* end = y.data + y.n - m + 1;
+            for (const unsigned char* it = y.data; it < end; ++it) {
+                it = static_cast<const unsigned char*>(memchr(it, x[0], end - it));
+                if (it == nullptr) {
+                    break;
+                }
+                if (memcmp(it + 1, x + 1, m - 1) == 0) {
+                    return it - y.data;
+                }
+            }
+            return y.n;
+        }
+        for (size_t j = 0; j + m <= y.n; j++) {
+            size_t i = 0;
+            while (i < m && x[i] == y[j + i]) {
+                ++i;
+            }
+            if (i == m) {
+                return j;
+            }
+        }
+        return y.n;
+    }
+
+    size_t twoWay(const Text& y, size_t j) const {
+        ptrdiff_t m = needle.size();
+        const unsigned char* x = needle.data();
+        ptrdiff_t n = y.n;
+        if (periodic) {
+            ptrdiff_t memory = -1;
+            while (static_cast<ptrdiff_t>(j) <= n - m) {
+                ptrdiff_t i = std::max(ell, memory) + 1;
+                while (i < m && x[i] == y[i + j]) {
+                    ++i;
+                }
+                if (i >= m) {
+                    i = ell;
+                    while (i > memory && x[i] == y[i + j]) {
+                        --i;
+                    }
+                    if (i <= memory) {
+                        return j;
+                    }
+                    j += period;
+                    memory = m - period - 1;
+                } else {
+                    j += i - ell;
+                    memory = -1;
+                }
+            }
+        } else {
+            while (static_cast<ptrdiff_t>(j) <= n - m) {
+                ptrdiff_t i = ell + 1;
+                while (i < m && x[i] == y[i + j]) {
+                    ++i;
+                }
+                if (i >= m) {
+                    i = ell;
+                    while (i >= 0 && x[i] == y[i + j]) {
+                        --i;
+                    }
+                    if (i < 0) {
+                        return j;
+                    }
+                    j += period;
+                } else {
+                    j += i - ell;
+                }
+            }
+        }
+        return y.n;
+    }
+
+    size_t horspool(const Text& y) const {
+        size_t m = needle.size();
+        const unsigned char* x = needle.data();
+        size_t budget = 4 * y.n + m;
+        size_t j = 0;
+        while (j + m <= y.n) {
+            unsigned char c = y[j + m - 1];
+            if (c == x[m - 1]) {
+                size_t i = 0;
+                while (i + 1 < m && x[i] == y[j + i]) {
+                    ++i;
+                }
+                if (i + 1 == m) {
+                    return j;
+                }
+                if (budget < i + 1) {
+                    return twoWay(y, j);
+                }
+                budget -= i + 1;
+            }
+            j += shift[c];
+        }
+        return y.n;
+    }
+
+    static size_t scanForward(const unsigned char* y, size_t n, const unsigned char* x, size_t m) {
+        const unsigned char* end = y + n - m + 1;
+        for (const unsigned char* it = y; it < end; ++it) {
+            it = static_cast<const unsigned char*>(memchr(it, x[0], end - it));
+            if (it == nullptr) {
+                break;
+            }
+            if (memcmp(it + 1, x + 1, m - 1) == 0) {
+                return it - y;
+            }
+        }
+        return n;
+    }
+
+    static size_t scanBackward(const unsigned char* y, size_t n, const unsigned char* x, size_t m) {
+        for (size_t j = n - m + 1; j-- > 0;) {
+            if (y[j] == x[0] && memcmp(y + j + 1, x + 1, m - 1) == 0) {
+                return j;
+            }
+        }
+        return n;
+    }
+
+public:
+    static size_t search(const char* text, size_t n, const char* pattern, size_t m) {
+        if (m == 0 || m > SHORT_NEEDLE) {
+            return BasicSearcher(pattern, m).find(text, n);
+        }
+        if (m > n) {
+            return n;
+        }
+        const unsigned char* y = reinterpret_cast<const unsigned char*>(text);
+        const unsigned char* x = reinterpret_cast<const unsigned char*>(pattern);
+        return reverse ? scanBackward(y, n, x, m) : scanForward(y, n, x, m);
+    }
+
+    BasicSearcher(const char* pattern, size_t m) : needle(pattern, pattern + m) {
+        if (reverse) {
+            std::reverse(needle.begin(), needle.end());
+        }
+        if (m == 0) {
+            kind = Kind::EMPTY;
+        } else if (m <= SHORT_NEEDLE) {
+            kind = Kind::BYTE_SCAN;
+        } else {
+            prepareTwoWay();
+            kind = Kind::TWO_WAY;
+            if (m >= LONG_NEEDLE) {
+                bool seen[256] = {};
+                size_t distinct = 0;
+                for (unsigned char c : needle) {
+                    distinct += !seen[c];
+                    seen[c] = true;
+                }
+                if (distinct >= RICH_ALPHABET) {
+                    prepareHorspool();
+                    kind = Kind::HORSPOOL;
+                }
+            }
+        }
+    }
+
+    size_t length() const {
+        return needle.size();
+    }
+
+    size_t find(const char* text, size_t n) const {
+        size_t m = needle.size();
+        if (m > n) {
+            return n;
+        }
+        Text y{reinterpret_cast<const unsigned char*>(text), n};
+        size_t pos = n;
+        switch (kind) {
+            case Kind::EMPTY:
+                pos = 0;
+                break;
+            case Kind::BYTE_SCAN:
+                pos = byteScan(y);
+                break;
+            case Kind::TWO_WAY:
+                pos = twoWay(y, 0);
+                break;
+            case Kind::HORSPOOL:
+                pos = horspool(y);
+                break;
+        }
+        if (pos == n || !reverse) {
+            return pos;
+        }
+        return n - m - pos;
+    }
+};
+
+using Searcher = BasicSearcher<false>;
+using ReverseSearcher = BasicSearcher<true>;
+
+class SplitRange;
+
+class StringView {
+private:
+    const char* str = nullptr;
+    size_t len = 0;
+
+public:
+    StringView() {}
+
+    StringView(const char* data, size_t count) : str(data), len(count) {}
+
+    StringView(const char* string) : str(string), len(strlen(string)) {}
+
+    const char* data() const {
+        return str;
+    }
+
+    size_t length() const {
+        return len;
+    }
+
+    bool empty() const {
+        return len == 0;
+    }
+
+    const char& operator[](size_t ind) const {
+        return str[ind];
+    }
+
+    const char& front() const {
+        return str[0];
+    }
+
+    const char& back() const {
+        return str[len - 1];
+    }
+
+    const char* begin() const {
+        return str;
+    }
+
+    const char* end() const {
+        return str + len;
+    }
+
+    StringView substr(size_t start, size_t count) const {
+        return StringView(str + start, count);
+    }
+
+    int compare(StringView rhs) const {
+        return StringKernels::compare(str, len, rhs.str, rhs.len);
+    }
+
+    size_t find(char c) const {
+        return StringKernels::findByte(str, len, c);
+    }
+
+    size_t find(StringView substring) const {
+        return Searcher::search(str, len, substring.str, substring.len);
+    }
+
+    size_t find(const Searcher& searcher) const {
+        return searcher.find(str, len);
+    }
+
+    size_t rfind(StringView substring) const {
+        return ReverseSearcher::search(str, len, substring.str, substring.len);
+    }
+
+    size_t rfind(const ReverseSearcher& searcher) const {
+        return searcher.find(str, len);
+    }
+
+    SplitRange split(char delim, bool skipEmpty = false) const;
+};
+
+bool operator == (StringView left, StringView right) {
+    return left.length() == right.length() && StringKernels::equal(left.data(), right.data(), left.length());
+}
+
+bool operator != (StringView left, StringView right) {
+    return !(left == right);
+}
+
+bool operator < (StringView left, StringView right) {
+    return left.compare(right) < 0;
+}
+
+std::ostream& operator << (std::ostream& out, StringView s) {
+    out.write(s.data(), s.length());
+    return out;
+}
+
+class SplitRange {
+private:
+    StringView text;
+    char delim;
+    bool skipEmpty;
+
+public:
+    class iterator {
+    private:
+        const char* pos;
+        const char* fieldEnd;
+        const char* end;
+        char delim;
+        bool skipEmpty;
+        bool done;
+
+        void findField() {
+            while (skipEmpty && pos < end && *pos == delim) {
+                ++pos;
+            }
+            if (skipEmpty && pos == end) {
+                done = true;
+                return;
+            }
+            if (pos == end) {
+                fieldEnd = end;
+                return;
+            }
+            const void* next = memchr(pos, delim, end - pos);
+            fieldEnd = next == nullptr ? end : static_cast<const char*>(next);
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = StringView;
+        using reference = StringView;
+        using pointer = const StringView*;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() : pos(nullptr), fieldEnd(nullptr), end(nullptr), delim(0), skipEmpty(false), done(true) {}
+
+        iterator(StringView text, char delim, bool skipEmpty)
+                : pos(text.begin()), fieldEnd(nullptr), end(text.end()), delim(delim), skipEmpty(skipEmpty),
+                  done(false) {
+            findField();
+        }
+
+        StringView operator*() const {
+            return StringView(pos, fieldEnd - pos);
+        }
+
+        iterator& operator++() {
+            if (fieldEnd == end) {
+                done = true;
+            } else {
+                pos = fieldEnd + 1;
+                findField();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator res = *this;
+            ++(*this);
+            return res;
+        }
+
+        bool operator == (const iterator& other) const {
+            return done == other.done && (done || pos == other.pos);
+        }
+
+        bool operator != (const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    SplitRange(StringView text, char delim, bool skipEmpty) : text(text), delim(delim), skipEmpty(skipEmpty) {}
+
+    iterator begin() const {
+        return iterator(text, delim, skipEmpty);
+    }
+
+    iterator end() const {
+        return iterator();
+    }
+};
+
+SplitRange StringView::split(char delim, bool skipEmpty) const {
+    return SplitRange(*this, delim, skipEmpty);
+}
+
+namespace std {
+template<>
+struct hash<StringView> {
+    size_t operator()(StringView s) const {
+        return StringKernels::hash(s.data(), s.length());
+    }
+};
+}
+
+class String {
+private:
+    static const size_t LOCAL_CAPACITY = 16;
+
+    size_t len = 0;
+    char* str = local;
+    union {
+        size_t capacity;
+        char local[LOCAL_CAPACITY];
+    };
+
+    bool isLocal() const {
+        return str == local;
+    }
+
+    size_t currentCapacity() const {
+        return isLocal() ? LOCAL_CAPACITY : capacity;
+    }
+
+    void allocate(size_t n) {
+        len = n;
+        if (n > LOCAL_CAPACITY) {
+            str = new char[n];
+            capacity = n;
+        }
+    }
+    
+    void swap(String& other) {
+        if (!isLocal() && !other.isLocal()) {
+            std::swap(str, other.str);
+            std::swap(capacity, other.capacity);
+        } else if (isLocal() && other.isLocal()) {
+            char tmp[LOCAL_CAPACITY];
+            memcpy(tmp, local, LOCAL_CAPACITY);
+            memcpy(local, other.local, LOCAL_CAPACITY);
+            memcpy(other.local, tmp, LOCAL_CAPACITY);
+        } else {
+            String& shortStr = isLocal() ? *this : other;
+            String& longStr = isLocal() ? other : *this;
+            char* heap = longStr.str;
+            size_t heapCapacity = longStr.capacity;
+            memcpy(longStr.local, shortStr.local, LOCAL_CAPACITY);
+            longStr.str = longStr.local;
+            shortStr.str = heap;
+            shortStr.capacity = heapCapacity;
+        }
+        std::swap(len, other.len);
     }
 
 public:
@@ -37,29 +728,60 @@ public:
 
     String(char c) : String(1, c) {}
 
-    String(const char* string) : len(strlen(string)), capacity(strlen(string)) {
-        str = new char[capacity];
+    String(const char* string) {
+        allocate(strlen(string));
         memcpy(str, string, len);
     }
 
-    String(size_t n, char c) : len(n), capacity(n) {
-        str = new char[capacity];
+    String(size_t n, char c) {
+        allocate(n);
         memset(str, c, n);
     }
 
-    String(const String& s) : len(s.len), capacity(s.len) {
-        str = new char[capacity];
+    explicit String(StringView s) {
+        allocate(s.length());
+        memcpy(str, s.data(), len);
+    }
+
+    String(const String& s) {
+        allocate(s.len);
         memcpy(str, s.str, len);
     }
 
+    String(String&& s) : len(s.len) {
+        if (s.isLocal()) {
+            memcpy(local, s.local, LOCAL_CAPACITY);
+        } else {
+            str = s.str;
+            capacity = s.capacity;
+            s.str = s.local;
+        }
+        s.len = 0;
+    }
+
     String& operator=(const String& s) {
+        if (s.len <= currentCapacity()) {
+            memmove(str, s.str, s.len);
+            len = s.len;
+            return *this;
+        }
         String ss(s);
         swap(ss);
         return *this;
     }
 
+    String& operator=(String&& s) {
+        if (this != &s) {
+            String ss(std::move(s));
+            swap(ss);
+        }
+        return *this;
+    }
+
     ~String() {
-        delete[] str;
+        if (!isLocal()) {
+            delete[] str;
+        }
     }
 
     size_t length() const {
@@ -71,15 +793,20 @@ public:
     }
 
     void clear() {
-        delete[] str;
-        str = nullptr;
         len = 0;
-        capacity = 0;
+    }
+
+    void shrink_to_fit() {
+        if (isLocal() || len == capacity) {
+            return;
+        }
+        String ss(*this);
+        swap(ss);
     }
 
     void push_back(char c) {
-        if (len == capacity) {
-            reserve(capacity == 0 ? 1 : 2 * capacity);
+        if (len == currentCapacity()) {
+            reserve(2 * len);
         }
         str[len++] = c;
     }
@@ -112,73 +839,523 @@ public:
         return str[len - 1];
     }
 
-    String& operator += (const String& rhs) {
-        if (capacity == 0) {
-            reserve(1);
+    void reserve(size_t newcap) {
+        if (newcap <= currentCapacity()) {
+            return;
         }
-        while (capacity < len + rhs.len) {
-            reserve(capacity * 2);
+        char* newstr = new char[newcap];
+        memcpy(newstr, str, len);
+        if (!isLocal()) {
+            delete[] str;
         }
-        memcpy(str + len, rhs.str, rhs.len);
-        len += rhs.len;
+        str = newstr;
+        capacity = newcap;
+    }
+
+    String& append(const char* data, size_t count) {
+        if (currentCapacity() < len + count) {
+            size_t newcap = std::max(2 * currentCapacity(), len + count);
+            char* newstr = new char[newcap];
+            memcpy(newstr, str, len);
+            memcpy(newstr + len, data, count);
+            if (!isLocal()) {
+                delete[] str;
+            }
+            str = newstr;
+            capacity = newcap;
+        } else {
+            memcpy(str + len, data, count);
+        }
+        len += count;
         return *this;
     }
 
+    String& append(StringView rhs) {
+        return append(rhs.data(), rhs.length());
+    }
+
+    String& operator += (const String& rhs) {
+        return append(rhs.str, rhs.len);
+    }
+
     String substr(size_t start, size_t count) const {
         String res(count, '\0');
         memcpy(res.str, str + start, count);
         return res;
     }
 
+    StringView substr_view(size_t start, size_t count) const {
+        return StringView(str + start, count);
+    }
+
+    operator StringView() const {
+        return StringView(str, len);
+    }
+
+    const char* data() const {
+        return str;
+    }
+
+    SplitRange split(char delim, bool skipEmpty = false) const {
+        return SplitRange(StringView(str, len), delim, skipEmpty);
+    }
+
     bool operator == (const String& rhs) const {
-        if (length() != rhs.length()) {
-            return false;
-        }
-        return isSubstring(0, rhs);
+        return len == rhs.len && StringKernels::equal(str, rhs.str, len);
     }
 
-    size_t find(const String& substring) const {
-        for (size_t i = 0; i + substring.length() <= len; ++i) {
-            if (isSubstring(i, substring)) {
-                return i;
-            }
-        }
-        return len;
+    bool operator != (const String& rhs) const {
+        return !(*this == rhs);
     }
 
-    size_t rfind(const String& substring) const {
-        for (int i = static_cast<int>(len) - substring.length(); i >= 0; --i) {
-            if (isSubstring(i, substring)) {
-                return i;
-            }
-        }
-        return len;
+    int compare(const String& rhs) const {
+        return StringKernels::compare(str, len, rhs.str, rhs.len);
+    }
+
+    int compareIgnoreCase(const String& rhs) const {
+        return StringKernels::compareIgnoreCase(str, len, rhs.str, rhs.len);
+    }
+
+    bool equalsIgnoreCase(const String& rhs) const {
+        return len == rhs.len && compareIgnoreCase(rhs) == 0;
+    }
+
+    size_t count(char c) const {
+        return StringKernels::countByte(str, len, c);
+    }
+
+    size_t find(char c) const {
+        return StringKernels::findByte(str, len, c);
+    }
+
+    size_t find(StringView substring) const {
+        return Searcher::search(str, len, substring.data(), substring.length());
+    }
+
+    size_t find(const Searcher& searcher) const {
+        return searcher.find(str, len);
+    }
+
+    size_t rfind(StringView substring) const {
+        return ReverseSearcher::search(str, len, substring.data(), substring.length());
+    }
+
+    size_t rfind(const ReverseSearcher& searcher) const {
+        return searcher.find(str, len);
     }
 };
 
 std::ostream& operator << (std::ostream& out, const String& s) {
-    for (size_t i = 0; i < s.length(); ++i) {
-        out << s[i];
-    }
+    out.write(s.data(), s.length());
     return out;
 }
 
+bool operator < (const String& left, const String& right) {
+    return left.compare(right) < 0;
+}
+
+bool operator > (const String& left, const String& right) {
+    return right < left;
+}
+
+bool operator <= (const String& left, const String& right) {
+    return !(right < left);
+}
+
+bool operator >= (const String& left, const String& right) {
+    return !(left < right);
+}
+
 std::istream& operator >> (std::istream& in, String& str) {
+    std::istream::sentry sentry(in);
+    if (!sentry) {
+        return in;
+    }
+    str.clear();
+    std::streambuf* buf = in.rdbuf();
+    char chunk[256];
+    size_t n = 0;
+    int c = buf->sgetc();
+    while (c != EOF && !isspace(c)) {
+        chunk[n++] = static_cast<char>(c);
+        if (n == sizeof(chunk)) {
+            str.append(chunk, n);
+            n = 0;
+        }
+        c = buf->snextc();
+    }
+    str.append(chunk, n);
+    if (c == EOF) {
+        in.setstate(std::ios::eofbit);
+    }
+    if (str.empty()) {
+        in.setstate(std::ios::failbit);
+    }
+    return in;
+}
+
+std::istream& getline(std::istream& in, String& str, char delim = '\n') {
+    std::istream::sentry sentry(in, true);
+    if (!sentry) {
+        return in;
+    }
     str.clear();
-    char c;
-    do {
-        c = in.get();
-    } while (isspace(c));
-    while (!in.eof() && !isspace(c)) {
-        str.push_back(c);
-        c = in.get();
+    std::streambuf* buf = in.rdbuf();
+    char chunk[256];
+    size_t n = 0;
+    bool any = false;
+    int c = buf->sgetc();
+    while (c != EOF) {
+        any = true;
+        if (c == static_cast<unsigned char>(delim)) {
+            buf->sbumpc();
+            break;
+        }
+        chunk[n++] = static_cast<char>(c);
+        if (n == sizeof(chunk)) {
+            str.append(chunk, n);
+            n = 0;
+        }
+        c = buf->snextc();
+    }
+    str.append(chunk, n);
+    if (c == EOF) {
+        in.setstate(any ? std::ios::eofbit : std::ios::eofbit | std::ios::failbit);
     }
     return in;
 }
 
+class LineReader {
+private:
+    const char* pos;
+    const char* end;
+
+public:
+    explicit LineReader(StringView text) : pos(text.begin()), end(text.end()) {}
+
+    bool next(StringView& line) {
+        if (pos == end) {
+            return false;
+        }
+        const char* newline = static_cast<const char*>(memchr(pos, '\n', end - pos));
+        const char* lineEnd = newline == nullptr ? end : newline;
+        line = StringView(pos, lineEnd - pos);
+        pos = newline == nullptr ? end : newline + 1;
+        return true;
+    }
+};
+
+class MappedFile {
+private:
+    const char* str = nullptr;
+    size_t len = 0;
+    bool mapped = false;
+    String fallback;
+
+public:
+    explicit MappedFile(const char* path) {
+#ifdef STRING_HAS_MMAP
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            throw("Cannot open file.");
+        }
+        struct stat st;
+        bool known = fstat(fd, &st) == 0;
+        if (known && S_ISDIR(st.st_mode)) {
+            close(fd);
+            throw("Cannot open file.");
+        }
+        if (known && S_ISREG(st.st_mode) && st.st_size > 0) {
+            size_t size = static_cast<size_t>(st.st_size);
+            void* memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (memory != MAP_FAILED) {
+                madvise(memory, size, MADV_SEQUENTIAL);
+                str = static_cast<const char*>(memory);
+                len = size;
+                mapped = true;
+            }
+        }
+        close(fd);
+        if (mapped) {
+            return;
+        }
+#endif
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw("Cannot open file.");
+        }
+        char chunk[1 << 16];
+        while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+            fallback.append(chunk, static_cast<size_t>(file.gcount()));
+        }
+        if (file.bad()) {
+            throw("Cannot read file.");
+        }
+        str = fallback.data();
+        len = fallback.length();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef STRING_HAS_MMAP
+        if (mapped) {
+            munmap(const_cast<char*>(str), len);
+        }
+#endif
+    }
+
+    StringView view() const {
+        return StringView(str, len);
+    }
+
+    LineReader lines() const {
+        return LineReader(view());
+    }
+};
+
+namespace std {
+template<>
+struct hash<String> {
+    size_t operator()(const String& s) const {
+        return StringKernels::hash(s.data(), s.length());
+    }
+};
+}
+
 String operator + (const String& lhs, const String& rhs) {
-    String ans = lhs;
+    String ans;
+    ans.reserve(lhs.length() + rhs.length());
+    ans += lhs;
     ans += rhs;
     return ans;
 }
 
+String operator + (String&& lhs, const String& rhs) {
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+String operator + (String&& lhs, String&& rhs) {
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+String operator + (const String& lhs, String&& rhs) {
+    return lhs + static_cast<const String&>(rhs);
+}
+
+
+
+class SharedString {
+private:
+    struct Record {
+        std::atomic<size_t> refs;
+        std::atomic<size_t> hash;
+        size_t len;
+        bool interned;
+        char data[1];
+    };
+
+    Record* rec = nullptr;
+
+    static Record* createRecord(StringView s, bool interned, size_t hash = 0) {
+        void* memory = ::operator new(sizeof(Record) + s.length());
+        Record* res = static_cast<Record*>(memory);
+        new (&res->refs) std::atomic<size_t>(1);
+        new (&res->hash) std::atomic<size_t>(hash);
+        res->len = s.length();
+        res->interned = interned;
+        memcpy(res->data, s.data(), s.length());
+        return res;
+    }
+
+    static void destroyRecord(Record* r) {
+        r->refs.~atomic();
+        r->hash.~atomic();
+        ::operator delete(r);
+    }
+
+    void retain() const {
+        if (rec != nullptr && !rec->interned) {
+            rec->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release() {
+        if (rec != nullptr && !rec->interned && rec->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroyRecord(rec);
+        }
+    }
+
+    explicit SharedString(Record* r) : rec(r) {}
+
+    friend class InternPool;
+
+public:
+    SharedString() {}
+
+    explicit SharedString(StringView s) : rec(s.empty() ? nullptr : createRecord(s, false)) {}
+
+    SharedString(const SharedString& other) : rec(other.rec) {
+        retain();
+    }
+
+    SharedString(SharedString&& other) : rec(other.rec) {
+        other.rec = nullptr;
+    }
+
+    SharedString& operator = (SharedString other) {
+        std::swap(rec, other.rec);
+        return *this;
+    }
+
+    ~SharedString() {
+        release();
+    }
+
+    static SharedString intern(StringView s);
+
+    size_t length() const {
+        return rec == nullptr ? 0 : rec->len;
+    }
+
+    bool empty() const {
+        return rec == nullptr;
+    }
+
+    const char* data() const {
+        return rec == nullptr ? "" : rec->data;
+    }
+
+    bool isInterned() const {
+        return rec == nullptr || rec->interned;
+    }
+
+    const char& operator[](size_t ind) const {
+        return rec->data[ind];
+    }
+
+    operator StringView() const {
+        return StringView(data(), length());
+    }
+
+    size_t hash() const {
+        if (rec == nullptr) {
+            return std::hash<StringView>()(StringView());
+        }
+        size_t res = rec->hash.load(std::memory_order_relaxed);
+        if (res == 0) {
+            res = std::hash<StringView>()(*this);
+            rec->hash.store(res, std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+    bool operator == (const SharedString& rhs) const {
+        if (rec == rhs.rec) {
+            return true;
+        }
+        if (isInterned() && rhs.isInterned()) {
+            return false;
+        }
+        return StringView(*this) == StringView(rhs);
+    }
+
+    bool operator != (const SharedString& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+class InternPool {
+private:
+    static const size_t SHARDS = 16;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<StringView, SharedString::Record*> table;
+    };
+
+    Shard shards[SHARDS];
+    std::atomic<size_t> entries{0};
+    std::atomic<size_t> bytes{0};
+    std::atomic<size_t> maxEntries{1 << 20};
+    std::atomic<size_t> maxBytes{size_t(64) << 20};
+
+    InternPool() = default;
+
+    static bool reserve(std::atomic<size_t>& counter, size_t amount, size_t limit) {
+        size_t current = counter.load(std::memory_order_relaxed);
+        do {
+            if (current + amount > limit) {
+                return false;
+            }
+        } while (!counter.compare_exchange_weak(current, current + amount, std::memory_order_relaxed));
+        return true;
+    }
+
+public:
+    static InternPool& getPool() {
+        static InternPool instance;
+        return instance;
+    }
+
+    ~InternPool() {
+        for (Shard& shard : shards) {
+            for (auto& entry : shard.table) {
+                SharedString::destroyRecord(entry.second);
+            }
+        }
+    }
+
+    void setLimits(size_t newMaxEntries, size_t newMaxBytes) {
+        maxEntries.store(newMaxEntries, std::memory_order_relaxed);
+        maxBytes.store(newMaxBytes, std::memory_order_relaxed);
+    }
+
+    size_t size() const {
+        return entries.load(std::memory_order_relaxed);
+    }
+
+    size_t memoryUsage() const {
+        return bytes.load(std::memory_order_relaxed);
+    }
+
+    SharedString intern(StringView s) {
+        if (s.empty()) {
+            return SharedString();
+        }
+        size_t hash = std::hash<StringView>()(s);
+        Shard& shard = shards[hash % SHARDS];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.table.find(s);
+        if (it != shard.table.end()) {
+            return SharedString(it->second);
+        }
+        size_t cost = sizeof(SharedString::Record) + s.length();
+        if (!reserve(entries, 1, maxEntries.load(std::memory_order_relaxed))) {
+            return SharedString(s);
+        }
+        if (!reserve(bytes, cost, maxBytes.load(std::memory_order_relaxed))) {
+            entries.fetch_sub(1, std::memory_order_relaxed);
+            return SharedString(s);
+        }
+        SharedString::Record* rec = SharedString::createRecord(s, true, hash);
+        shard.table.emplace(StringView(rec->data, rec->len), rec);
+        return SharedString(rec);
+    }
+};
+
+SharedString SharedString::intern(StringView s) {
+    return InternPool::getPool().intern(s);
+}
+
+namespace std {
+template<>
+struct hash<SharedString> {
+    size_t operator()(const SharedString& s) const {
+        return s.hash();
+    }
+};
+}
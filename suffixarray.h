@@ -0,0 +1,374 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "string.h"
+
+class SuffixArray {
+private:
+    static constexpr size_t BLOCK = 64;
+    static constexpr uint64_t MAGIC = 0x3130585241465553ull;
+    static constexpr uint32_t NONE = ~0u;
+
+    String source;
+    std::vector<uint32_t> suffixes;
+    std::vector<uint32_t> lcps;
+    std::vector<uint32_t> blockMins;
+    std::unique_ptr<MappedFile> file;
+
+    size_t n = 0;
+    const char* str = nullptr;
+    const uint32_t* sa = nullptr;
+    const uint32_t* lcpArray = nullptr;
+    const uint32_t* mins = nullptr;
+
+    SuffixArray() {}
+
+    void bind() {
+        str = source.data();
+        sa = suffixes.data();
+        lcpArray = lcps.data();
+        mins = blockMins.data();
+    }
+
+    static size_t blockCount(size_t n) {
+        return (n + BLOCK - 1) / BLOCK;
+    }
+
+    template<typename Index>
+    static std::vector<Index> induce(const std::vector<Index>& s, Index upper) {
+        Index n = static_cast<Index>(s.size());
+        if (n == 0) {
+            return {};
+        }
+        if (n == 1) {
+            return {0};
+        }
+        if (n == 2) {
+            return s[0] < s[1] ? std::vector<Index>{0, 1} : std::vector<Index>{1, 0};
+        }
+        std::vector<Index> res(n);
+        std::vector<bool> isS(n);
+        for (Index i = n - 2; i >= 0; i--) {
+            isS[i] = s[i] == s[i + 1] ? isS[i + 1] : s[i] < s[i + 1];
+        }
+        std::vector<Index> sumL(upper + 1), sumS(upper + 1);
+        for (Index i = 0; i < n; i++) {
+            if (!isS[i]) {
+                sumS[s[i]]++;
+            } else {
+                sumL[s[i] + 1]++;
+            }
+        }
+        for (Index i = 0; i <= upper; i++) {
+            sumS[i] += sumL[i];
+            if (i < upper) {
+                sumL[i + 1] += sumS[i];
+            }
+        }
+        std::vector<Index> bucket(upper + 1);
+        auto sortFrom = [&](const std::vector<Index>& lms) {
+            std::fill(res.begin(), res.end(), -1);
+            std::copy(sumS.begin(), sumS.end(), bucket.begin());
+            for (Index d : lms) {
+                if (d != n) {
+                    res[bucket[s[d]]++] = d;
+                }
+            }
+            std::copy(sumL.begin(), sumL.end(), bucket.begin());
+            res[bucket[s[n - 1]]++] = n - 1;
+            for (Index i = 0; i < n; i++) {
+                Index v = res[i];
+                if (v >= 1 && !isS[v - 1]) {
+                    res[bucket[s[v - 1]]++] = v - 1;
+                }
+            }
+            std::copy(sumL.begin(), sumL.end(), bucket.begin());
+            for (Index i = n - 1; i >= 0; i--) {
+                Index v = res[i];
+                if (v >= 1 && isS[v - 1]) {
+                    res[--bucket[s[v - 1] + 1]] = v - 1;
+                }
+            }
+        };
+        std::vector<Index> lmsIndex(static_cast<size_t>(n) + 1, -1);
+        std::vector<Index> lms;
+        for (Index i = 1; i < n; i++) {
+            if (!isS[i - 1] && isS[i]) {
+                lmsIndex[i] = static_cast<Index>(lms.size());
+                lms.push_back(i);
+            }
+        }
+        Index m = static_cast<Index>(lms.size());
+        sortFrom(lms);
+        if (m == 0) {
+            return res;
+        }
+        std::vector<Index> sortedLms;
+        sortedLms.reserve(m);
+        for (Index v : res) {
+            if (lmsIndex[v] != -1) {
+                sortedLms.push_back(v);
+            }
+        }
+        std::vector<Index> reduced(m);
+        Index reducedUpper = 0;
+        reduced[lmsIndex[sortedLms[0]]] = 0;
+        for (Index i = 1; i < m; i++) {
+            Index l = sortedLms[i - 1];
+            Index r = sortedLms[i];
+            Index endL = lmsIndex[l] + 1 < m ? lms[lmsIndex[l] + 1] : n;
+            Index endR = lmsIndex[r] + 1 < m ? lms[lmsIndex[r] + 1] : n;
+            bool same = endL - l == endR - r;
+            if (same) {
+                while (l < endL && s[l] == s[r]) {
+                    l++;
+                    r++;
+                }
+                same = l != n && s[l] == s[r];
+            }
+            if (!same) {
+                reducedUpper++;
+            }
+            reduced[lmsIndex[sortedLms[i]]] = reducedUpper;
+        }
+        std::vector<Index> reducedSa = induce(reduced, reducedUpper);
+        for (Index i = 0; i < m; i++) {
+            sortedLms[i] = lms[reducedSa[i]];
+        }
+        sortFrom(sortedLms);
+        return res;
+    }
+
+    template<typename F>
+    static void parallelFor(size_t n, unsigned threads, F f) {
+        threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(n / (1 << 16) + 1)));
+        std::vector<std::thread> workers;
+        size_t step = (n + threads - 1) / threads;
+        for (unsigned t = 1; t < threads; t++) {
+            size_t from = std::min(n, t * step);
+            size_t to = std::min(n, from + step);
+            workers.emplace_back([&f, from, to]() { f(from, to); });
+        }
+        f(0, std::min(n, step));
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    template<typename Index>
+    void sortSuffixes() {
+        std::vector<Index> s(n);
+        for (size_t i = 0; i < n; i++) {
+            s[i] = static_cast<unsigned char>(source[i]);
+        }
+        std::vector<Index> order = induce<Index>(s, 255);
+        s.clear();
+        s.shrink_to_fit();
+        suffixes.assign(order.begin(), order.end());
+    }
+
+    void build(unsigned threads) {
+        assert(n < NONE);
+        if (n <= static_cast<size_t>(INT32_MAX)) {
+            sortSuffixes<int32_t>();
+        } else {
+            sortSuffixes<int64_t>();
+        }
+
+        std::vector<uint32_t> rank(n);
+        parallelFor(n, threads, [this, &rank](size_t from, size_t to) {
+            for (size_t i = from; i < to; i++) {
+                rank[suffixes[i]] = static_cast<uint32_t>(i);
+            }
+        });
+        lcps.assign(n, 0);
+        const char* text = source.data();
+        parallelFor(n, threads, [this, &rank, text](size_t from, size_t to) {
+            size_t h = 0;
+            for (size_t i = from; i < to; i++) {
+                if (rank[i] == 0) {
+                    h = 0;
+                    continue;
+                }
+                size_t j = suffixes[rank[i] - 1];
+                while (i + h < n && j + h < n && text[i + h] == text[j + h]) {
+                    h++;
+                }
+                lcps[rank[i]] = static_cast<uint32_t>(h);
+                if (h > 0) {
+                    h--;
+                }
+            }
+        });
+
+        blockMins.assign(blockCount(n), NONE);
+        parallelFor(blockMins.size(), threads, [this](size_t from, size_t to) {
+            for (size_t b = from; b < to; b++) {
+                size_t end = std::min(n, (b + 1) * BLOCK);
+                blockMins[b] = *std::min_element(suffixes.begin() + b * BLOCK, suffixes.begin() + end);
+            }
+        });
+        bind();
+    }
+
+    int compareSuffix(size_t suffix, StringView pattern, size_t& common) const {
+        size_t limit = std::min(pattern.length(), n - suffix);
+        while (common < limit && str[suffix + common] == pattern[common]) {
+            common++;
+        }
+        if (common == pattern.length()) {
+            return 0;
+        }
+        if (common == limit) {
+            return -1;
+        }
+        return static_cast<unsigned char>(str[suffix + common]) < static_cast<unsigned char>(pattern[common]) ? -1 : 1;
+    }
+
+    size_t bound(StringView pattern, bool upper) const {
+        size_t low = 0;
+        size_t high = n;
+        size_t lowCommon = 0;
+        size_t highCommon = 0;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            size_t common = std::min(lowCommon, highCommon);
+            int cmp = compareSuffix(sa[mid], pattern, common);
+            if (cmp < 0 || (upper && cmp == 0)) {
+                low = mid + 1;
+                lowCommon = common;
+            } else {
+                high = mid;
+                highCommon = common;
+            }
+        }
+        return low;
+    }
+
+public:
+    explicit SuffixArray(StringView text, unsigned threads = std::thread::hardware_concurrency())
+            : source(text), n(text.length()) {
+        build(threads);
+    }
+
+    SuffixArray(const SuffixArray&) = delete;
+    SuffixArray& operator = (const SuffixArray&) = delete;
+
+    SuffixArray(SuffixArray&& other)
+            : source(std::move(other.source)), suffixes(std::move(other.suffixes)), lcps(std::move(other.lcps)),
+              blockMins(std::move(other.blockMins)), file(std::move(other.file)), n(other.n), str(other.str),
+              sa(other.sa), lcpArray(other.lcpArray), mins(other.mins) {
+        if (file == nullptr) {
+            bind();
+        }
+    }
+
+    SuffixArray& operator = (SuffixArray&& other) {
+        source = std::move(other.source);
+        suffixes = std::move(other.suffixes);
+        lcps = std::move(other.lcps);
+        blockMins = std::move(other.blockMins);
+        file = std::move(other.file);
+        n = other.n;
+        str = other.str;
+        sa = other.sa;
+        lcpArray = other.lcpArray;
+        mins = other.mins;
+        if (file == nullptr) {
+            bind();
+        }
+        return *this;
+    }
+
+    size_t size() const {
+        return n;
+    }
+
+    StringView text() const {
+        return StringView(str, n);
+    }
+
+    size_t operator[](size_t i) const {
+        return sa[i];
+    }
+
+    size_t lcp(size_t i) const {
+        return lcpArray[i];
+    }
+
+    std::pair<size_t, size_t> range(StringView pattern) const {
+        return {bound(pattern, false), bound(pattern, true)};
+    }
+
+    size_t count(StringView pattern) const {
+        std::pair<size_t, size_t> r = range(pattern);
+        return r.second - r.first;
+    }
+
+    std::vector<size_t> locate(StringView pattern) const {
+        std::pair<size_t, size_t> r = range(pattern);
+        std::vector<size_t> res(sa + r.first, sa + r.second);
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+
+    size_t find(StringView pattern) const {
+        std::pair<size_t, size_t> r = range(pattern);
+        size_t res = n;
+        size_t i = r.first;
+        for (; i < r.second && i % BLOCK != 0; i++) {
+            res = std::min<size_t>(res, sa[i]);
+        }
+        for (; i + BLOCK <= r.second; i += BLOCK) {
+            res = std::min<size_t>(res, mins[i / BLOCK]);
+        }
+        for (; i < r.second; i++) {
+            res = std::min<size_t>(res, sa[i]);
+        }
+        return res;
+    }
+
+    void save(const char* path) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            throw("Cannot open file.");
+        }
+        uint64_t header[2] = {MAGIC, n};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(sa), n * sizeof(uint32_t));
+        out.write(reinterpret_cast<const char*>(lcpArray), n * sizeof(uint32_t));
+        out.write(reinterpret_cast<const char*>(mins), blockCount(n) * sizeof(uint32_t));
+        out.write(str, n);
+        if (!out) {
+            throw("Cannot write file.");
+        }
+    }
+
+    static SuffixArray load(const char* path) {
+        SuffixArray res;
+        res.file.reset(new MappedFile(path));
+        StringView data = res.file->view();
+        uint64_t header[2];
+        if (data.length() < sizeof(header)) {
+            throw("Invalid index file.");
+        }
+        memcpy(header, data.data(), sizeof(header));
+        size_t n = header[1];
+        if (header[0] != MAGIC || data.length() != sizeof(header) + (2 * n + blockCount(n)) * sizeof(uint32_t) + n) {
+            throw("Invalid index file.");
+        }
+        const uint32_t* arrays = reinterpret_cast<const uint32_t*>(data.data() + sizeof(header));
+        res.n = n;
+        res.sa = arrays;
+        res.lcpArray = arrays + n;
+        res.mins = arrays + 2 * n;
+        res.str = reinterpret_cast<const char*>(arrays + 2 * n + blockCount(n));
+        return res;
+    }
+};